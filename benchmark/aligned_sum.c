@@ -0,0 +1,73 @@
+#include <stdint.h>
+#include <string.h>
+#include "./benchmark.h"
+#include "../vector.h"
+
+// summing a cache resident vector of floats with 32 byte loads, with the data only 16 byte aligned (what malloc guarantees,
+// a load every other cache line straddles two lines) and with the data aligned to 64 bytes
+#define ELEMENTS 4096
+#define ROUNDS   100000
+
+typedef float v8f __attribute__((vector_size(32)));
+
+// hands out cache line aligned blocks: the data, 80 bytes after the start of the block (the header), sits 16 bytes past a cache line
+static void *misaligned_alloc(void *context, size_t size) {
+    (void)context;
+    return aligned_alloc(64, (size + 63) & ~(size_t)63);
+}
+
+static void misaligned_free(void *context, void *ptr, size_t size) {
+    (void)context; (void)size;
+    free(ptr);
+}
+
+static void *misaligned_realloc(void *context, void *ptr, size_t old_size, size_t new_size) {
+    void *new_ptr = misaligned_alloc(context, new_size);
+    if (new_ptr == NULL) { return NULL; }
+    memcpy(new_ptr, ptr, old_size < new_size ? old_size : new_size);
+    misaligned_free(context, ptr, old_size);
+    return new_ptr;
+}
+
+static const Vector_Allocator misaligned_allocator = { misaligned_alloc, misaligned_realloc, misaligned_free, NULL };
+
+#if defined(__x86_64__)
+    __attribute__((target("avx")))
+#endif
+__attribute__((noinline)) static float sum(const float *data, size_t length) {
+    v8f acc0 = { 0 }, acc1 = { 0 }, acc2 = { 0 }, acc3 = { 0 };
+    for (size_t i = 0; i + 32 <= length; i += 32) {
+        v8f chunk0, chunk1, chunk2, chunk3;
+        // unaligned loads, the same instructions for both vectors
+        memcpy(&chunk0, data + i, sizeof(v8f));
+        memcpy(&chunk1, data + i + 8, sizeof(v8f));
+        memcpy(&chunk2, data + i + 16, sizeof(v8f));
+        memcpy(&chunk3, data + i + 24, sizeof(v8f));
+        acc0 += chunk0; acc1 += chunk1; acc2 += chunk2; acc3 += chunk3;
+    }
+    v8f total = acc0 + acc1 + acc2 + acc3;
+    float result = 0;
+    for (int j = 0; j < 8; j++) { result += total[j]; }
+    return result;
+}
+
+static void run(const char *name, float *vec) {
+    for (int i = 0; i < ELEMENTS; i++) { Vector_push(&vec, (float)(i & 7)); }
+    double start = benchmark_now();
+    for (int r = 0; r < ROUNDS; r++) { benchmark_use(sum(vec, Vector_get_length(&vec))); }
+    benchmark_report(name, benchmark_now() - start, (size_t)ROUNDS * ELEMENTS);
+    printf("    %-40s %10zu data address modulo 64\n", "", (size_t)((uintptr_t)vec % 64));
+    Vector_destroy(&vec);
+}
+
+int main(void) {
+    #if defined(__x86_64__)
+        if (!__builtin_cpu_supports("avx")) { printf("no AVX, skipping\n"); return 0; }
+    #endif
+    printf("summing %d floats %d times\n", ELEMENTS, ROUNDS);
+    Vector_set_default_allocator(&misaligned_allocator);
+    run("16 byte alignment", Vector_init(float));
+    run("64 byte alignment", Vector_init_aligned(float, 64));
+    Vector_set_default_allocator(NULL);
+    return 0;
+}
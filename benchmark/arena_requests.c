@@ -0,0 +1,56 @@
+#include "./benchmark.h"
+#include "../vector.h"
+
+// a request handler building a few dozen short lived vectors (parsing, filtering, mapping) and dropping them all at the end
+#define REQUESTS            20000
+#define VECTORS_PER_REQUEST 32
+#define ELEMENTS_PER_VECTOR 24
+
+static bool is_even(int element) { return element % 2 == 0; }
+static int twice(int element) { return element * 2; }
+
+static int handle_request(int **vectors, int seed) {
+    int checksum = 0;
+    for (int v = 0; v < VECTORS_PER_REQUEST; v += 2) {
+        int *vec = Vector_init(int);
+        for (int i = 0; i < ELEMENTS_PER_VECTOR; i++) { Vector_push(&vec, seed + v + i); }
+        int *evens = Vector_filter(&vec, is_even);
+        vectors[v] = vec;
+        vectors[v + 1] = Vector_map(&evens, twice, int);
+        checksum += vectors[v + 1][0];
+        Vector_destroy(&evens);
+    }
+    return checksum;
+}
+
+static void run_malloc(void) {
+    int *vectors[VECTORS_PER_REQUEST];
+    double start = benchmark_now();
+    for (int r = 0; r < REQUESTS; r++) {
+        benchmark_use(handle_request(vectors, r));
+        for (int v = 0; v < VECTORS_PER_REQUEST; v++) { Vector_destroy(&vectors[v]); }
+    }
+    benchmark_report("malloc, destroying every vector", benchmark_now() - start, REQUESTS);
+}
+
+static void run_arena(void) {
+    int *vectors[VECTORS_PER_REQUEST];
+    Vector_Arena arena;
+    Vector_arena_init(&arena, 0);
+    double start = benchmark_now();
+    for (int r = 0; r < REQUESTS; r++) {
+        Vector_arena_begin_scope(&arena);
+        benchmark_use(handle_request(vectors, r));
+        Vector_arena_end_scope(&arena);
+        Vector_arena_reset(&arena);
+    }
+    benchmark_report("arena, resetting once per request", benchmark_now() - start, REQUESTS);
+    Vector_arena_destroy(&arena);
+}
+
+int main(void) {
+    printf("%d requests of %d vectors of %d ints\n", REQUESTS, VECTORS_PER_REQUEST, ELEMENTS_PER_VECTOR);
+    run_malloc();
+    run_arena();
+    return 0;
+}
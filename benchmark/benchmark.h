@@ -0,0 +1,20 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <stdio.h>
+#include <time.h>
+
+// returns a monotonic timestamp in seconds
+static inline double benchmark_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// keeps the compiler from optimizing away a computed value
+#define benchmark_use(__value__) __asm__ __volatile__("" : : "r"(__value__) : "memory")
+
+#define benchmark_report(__name__, __seconds__, __operations__) \
+    printf("    %-40s %10.3f ms %10.2f ns/op\n", (__name__), (__seconds__) * 1e3, (__seconds__) * 1e9 / (double)(__operations__))
+
+#endif // BENCHMARK_H
@@ -0,0 +1,34 @@
+#include "./benchmark.h"
+#include "../vector.h"
+
+// a vector whose length oscillates a few elements around a power of two boundary
+// with the default policy every crossing upwards grows and every crossing downwards shrinks the vector again
+#define BOUNDARY   (1 << 16)
+#define AMPLITUDE  8
+#define ITERATIONS 20000
+
+static void run(const char *name, Vector_calculate_optimal_capacity_fn calculate_optimal_capacity_fn) {
+    int *vec = Vector_init(int);
+    Vector_set_calculate_optimal_capacity_fn(&vec, calculate_optimal_capacity_fn);
+    for (int i = 0; i < BOUNDARY - AMPLITUDE / 2; i++) { Vector_push(&vec, i); }
+
+    size_t resizes_before = Vector_get_resize_count();
+    double start = benchmark_now();
+    for (int i = 0; i < ITERATIONS; i++) {
+        for (int j = 0; j < AMPLITUDE; j++) { Vector_push(&vec, j); }
+        for (int j = 0; j < AMPLITUDE; j++) { Vector_pop(&vec); }
+    }
+    double elapsed = benchmark_now() - start;
+    size_t resizes = Vector_get_resize_count() - resizes_before;
+
+    benchmark_report(name, elapsed, ITERATIONS);
+    printf("    %-40s %10zu resizes for %d oscillations\n", "", resizes, ITERATIONS);
+    Vector_destroy(&vec);
+}
+
+int main(void) {
+    printf("push/pop oscillating by %d elements around %d elements\n", AMPLITUDE, BOUNDARY);
+    run("default (power of two) policy", NULL);
+    run("hysteresis policy", Vector_calculate_hysteresis_optimal_capacity);
+    return 0;
+}
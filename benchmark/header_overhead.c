@@ -0,0 +1,57 @@
+#include "./benchmark.h"
+#include "../vector.h"
+
+// an index made of many small inner vectors (like demo/vector_of_vectors.c), built once per header mode
+// (bin/header_overhead and bin/header_overhead_compact), the bytes are counted by the allocator
+#define INNER_VECTORS 1000000
+#define INNER_LENGTH  3
+
+static size_t live_bytes = 0;
+
+static void *counting_alloc(void *context, size_t size) {
+    (void)context;
+    live_bytes += size;
+    return malloc(size);
+}
+
+static void *counting_realloc(void *context, void *ptr, size_t old_size, size_t new_size) {
+    (void)context;
+    live_bytes += new_size - old_size;
+    return realloc(ptr, new_size);
+}
+
+static void counting_free(void *context, void *ptr, size_t size) {
+    (void)context;
+    live_bytes -= size;
+    free(ptr);
+}
+
+static const Vector_Allocator counting_allocator = { counting_alloc, counting_realloc, counting_free, NULL };
+
+static void free_inner_vectors(void *vec_ptr) {
+    int ***vec = (int ***)vec_ptr;
+    for (size_t i = 0; i < Vector_get_length(vec); i++) { Vector_destroy(&(*vec)[i]); }
+    Vector_deallocate(vec);
+}
+
+int main(void) {
+    Vector_set_default_allocator(&counting_allocator);
+    printf("%d inner vectors of %d ints, %s header of %zu bytes\n", INNER_VECTORS, INNER_LENGTH, VECTOR_COMPACT_HEADER ? "compact" : "full", sizeof(__Vector_Header));
+
+    double start = benchmark_now();
+    int **index = Vector_init(int *);
+    Vector_set_free_fn(&index, free_inner_vectors);
+    for (int i = 0; i < INNER_VECTORS; i++) {
+        int *inner = Vector_init(int);
+        for (int j = 0; j < INNER_LENGTH; j++) { Vector_push(&inner, i + j); }
+        Vector_push(&index, inner);
+    }
+    benchmark_report("building the index", benchmark_now() - start, INNER_VECTORS);
+
+    size_t outer_bytes = sizeof(__Vector_Header) + Vector_get_capacity(&index) * sizeof(int *);
+    size_t inner_bytes = (live_bytes - outer_bytes) / INNER_VECTORS;
+    printf("    %-40s %10zu bytes per inner vector (%zu of them elements)\n", "", inner_bytes, INNER_LENGTH * sizeof(int));
+    Vector_destroy(&index);
+    Vector_set_default_allocator(NULL);
+    return 0;
+}
@@ -0,0 +1,40 @@
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "./benchmark.h"
+#include "../vector.h"
+
+// a vector growing to a few hundred million elements, then scanned and shrunk
+// every run happens in a child process so the peak resident size is its own
+#define ELEMENTS ((size_t)256 << 20)
+
+static void run(const char *name, const Vector_Allocator *allocator) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        int *vec = Vector_init_with_allocator(int, allocator);
+        double start = benchmark_now();
+        for (size_t i = 0; i < ELEMENTS; i++) { Vector_push(&vec, (int)i); }
+        benchmark_report(name, benchmark_now() - start, ELEMENTS);
+
+        long long sum = 0;
+        start = benchmark_now();
+        for (size_t i = 0; i < ELEMENTS; i++) { sum += vec[i]; }
+        benchmark_use(sum);
+        benchmark_report("    scan", benchmark_now() - start, ELEMENTS);
+
+        Vector_destroy(&vec);
+        _exit(0);
+    }
+    int status;
+    struct rusage usage;
+    wait4(pid, &status, 0, &usage);
+    printf("    %-40s %10ld MiB peak resident\n", "", usage.ru_maxrss / 1024);
+}
+
+int main(void) {
+    setvbuf(stdout, NULL, _IONBF, 0);
+    printf("pushing %zu ints (%zu MiB)\n", ELEMENTS, ELEMENTS * sizeof(int) >> 20);
+    run("malloc", &Vector_malloc_allocator);
+    run("mmap", &Vector_mmap_allocator);
+    return 0;
+}
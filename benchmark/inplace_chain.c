@@ -0,0 +1,46 @@
+#include "./benchmark.h"
+#include "../vector.h"
+
+// a map then filter chain over a 4M element vector whose source is dropped after each step, with new vectors and in place
+#define LENGTH 4000000
+#define ROUNDS 10
+
+static int scale(int value) { return value * 3 + 1; }
+static bool is_even(int value) { return value % 2 == 0; }
+
+static int *make_vector(void) {
+    int *vec = Vector_init(int);
+    for (int i = 0; i < LENGTH; i++) { Vector_push(&vec, i); }
+    return vec;
+}
+
+int main(void) {
+    printf("map then filter of %d elements, %d times\n", LENGTH, ROUNDS);
+    size_t count = (size_t)ROUNDS * LENGTH;
+    double total = 0;
+    for (int r = 0; r < ROUNDS; r++) {
+        int *vec = make_vector();
+        double start = benchmark_now();
+        int *mapped = Vector_map(&vec, scale, int);
+        Vector_destroy(&vec);
+        int *filtered = Vector_filter(&mapped, is_even);
+        Vector_destroy(&mapped);
+        total += benchmark_now() - start;
+        benchmark_use(Vector_get_length(&filtered));
+        Vector_destroy(&filtered);
+    }
+    benchmark_report("Vector_map / Vector_filter", total, count);
+
+    total = 0;
+    for (int r = 0; r < ROUNDS; r++) {
+        int *vec = make_vector();
+        double start = benchmark_now();
+        Vector_map_inplace(&vec, scale);
+        Vector_filter_inplace(&vec, is_even);
+        total += benchmark_now() - start;
+        benchmark_use(Vector_get_length(&vec));
+        Vector_destroy(&vec);
+    }
+    benchmark_report("Vector_map_inplace / filter_inplace", total, count);
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include "./benchmark.h"
+#include "../vector.h"
+
+// filtering 8M log records (5% and 50% of them kept) with Vector_filter and with Vector_parallel_filter on 1, 2, 4, ... threads,
+// up to twice the number of online processors
+#define LENGTH 8000000
+
+typedef struct Log_Record {
+    int64_t timestamp;
+    int32_t level; // 0..99, the level below 5 is an error
+    int32_t source;
+} Log_Record;
+
+static int32_t threshold;
+
+static bool is_below_serial(Log_Record record) { return record.level < threshold; }
+static bool is_below(const void *record, void *context) { return ((const Log_Record *)record)->level < *(const int32_t *)context; }
+
+int main(void) {
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    printf("filtering %d records of %zu bytes, %ld online processors\n", LENGTH, sizeof(Log_Record), processors);
+    Log_Record *vec = Vector_init_with_capacity(Log_Record, LENGTH);
+    srand(42);
+    for (int i = 0; i < LENGTH; i++) {
+        Log_Record record = { 1700000000000LL + i, rand() % 100, rand() % 64 };
+        Vector_push(&vec, record);
+    }
+
+    int32_t thresholds[] = { 5, 50 };
+    for (size_t t = 0; t < sizeof(thresholds) / sizeof(*thresholds); t++) {
+        char label[64];
+        threshold = thresholds[t];
+        double start = benchmark_now();
+        Log_Record *filtered = Vector_filter(&vec, is_below_serial);
+        double serial = benchmark_now() - start;
+        snprintf(label, sizeof(label), "Vector_filter %d%% kept", threshold);
+        benchmark_report(label, serial, LENGTH);
+        Vector_destroy(&filtered);
+
+        for (size_t threads = 1; threads <= (size_t)(processors > 1 ? 2 * processors : 2); threads *= 2) {
+            Vector_parallel_set_thread_count(threads);
+            start = benchmark_now();
+            filtered = (Log_Record *)Vector_parallel_filter(&vec, is_below, &threshold);
+            double elapsed = benchmark_now() - start;
+            snprintf(label, sizeof(label), "parallel %d%% kept, %zu threads (x%.2f)", threshold, threads, serial / elapsed);
+            benchmark_report(label, elapsed, LENGTH);
+            Vector_destroy(&filtered);
+        }
+    }
+    Vector_destroy(&vec);
+    return 0;
+}
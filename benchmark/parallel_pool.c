@@ -0,0 +1,82 @@
+#include <stdlib.h>
+#include <unistd.h>
+#include "./benchmark.h"
+#include "../vector.h"
+
+// Vector_foreach/map/reduce against Vector_parallel_foreach/map/reduce on 16M ints with 1, 2, 4, ... threads up to twice the online processors,
+// then 2000 small parallel reductions (8K ints) on the pool kept between the calls and on a pool started again for every call
+#define LENGTH       16000000
+#define SMALL_LENGTH 8192
+#define SMALL_CALLS  2000
+
+static void scale(void *element, void *context) { (void)context; *(int *)element = *(int *)element * 3 + 1; }
+static void widen(const void *element, void *result, void *context) { (void)context; *(long *)result = (long)*(const int *)element * 7; }
+static void add(void *accumulator, const void *element, void *context) { (void)context; *(long *)accumulator += *(const int *)element; }
+static void combine(void *accumulator, const void *partial, void *context) { (void)context; *(long *)accumulator += *(const long *)partial; }
+
+static void scale_serial(int *element) { *element = *element * 3 + 1; }
+static long widen_serial(int element) { return (long)element * 7; }
+static long add_serial(long accumulator, int element) { return accumulator + element; }
+
+static volatile long sink;
+
+static void run(const char *name, size_t threads, int *vec) {
+    char label[64];
+    double start = benchmark_now();
+    if (threads == 0) { Vector_foreach(&vec, scale_serial); }
+    else { Vector_parallel_foreach(&vec, scale, NULL); }
+    snprintf(label, sizeof(label), "%s foreach", name);
+    benchmark_report(label, benchmark_now() - start, LENGTH);
+
+    start = benchmark_now();
+    long *mapped = threads == 0 ? Vector_map(&vec, widen_serial, long) : (long *)Vector_parallel_map(&vec, widen, sizeof(long), NULL);
+    snprintf(label, sizeof(label), "%s map", name);
+    benchmark_report(label, benchmark_now() - start, LENGTH);
+    Vector_destroy(&mapped);
+
+    start = benchmark_now();
+    long sum = 0;
+    if (threads == 0) { sum = Vector_reduce(&vec, add_serial, 0L); }
+    else { Vector_parallel_reduce(&vec, add, combine, &sum, sizeof(sum), NULL); }
+    sink = sum;
+    snprintf(label, sizeof(label), "%s reduce", name);
+    benchmark_report(label, benchmark_now() - start, LENGTH);
+}
+
+int main(void) {
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    printf("%d ints, %ld online processors\n", LENGTH, processors);
+    int *vec = Vector_init_with_capacity(int, LENGTH);
+    for (int i = 0; i < LENGTH; i++) { Vector_push(&vec, i & 0xffff); }
+
+    run("serial", 0, vec);
+    for (size_t threads = 1; threads <= (size_t)(processors > 1 ? 2 * processors : 2); threads *= 2) {
+        char name[32];
+        snprintf(name, sizeof(name), "%zu threads", threads);
+        Vector_parallel_set_thread_count(threads);
+        run(name, threads, vec);
+    }
+    Vector_destroy(&vec);
+
+    int *small = Vector_init_with_capacity(int, SMALL_LENGTH);
+    for (int i = 0; i < SMALL_LENGTH; i++) { Vector_push(&small, i); }
+    Vector_parallel_set_thread_count(processors > 1 ? (size_t)processors : 2);
+    Vector_parallel_set_grain_size(1024);
+    double start = benchmark_now();
+    for (int i = 0; i < SMALL_CALLS; i++) {
+        long sum = 0;
+        Vector_parallel_reduce(&small, add, combine, &sum, sizeof(sum), NULL);
+        sink = sum;
+    }
+    benchmark_report("small reduce, pool kept", benchmark_now() - start, SMALL_CALLS);
+    start = benchmark_now();
+    for (int i = 0; i < SMALL_CALLS; i++) {
+        long sum = 0;
+        Vector_parallel_reduce(&small, add, combine, &sum, sizeof(sum), NULL);
+        Vector_parallel_shutdown();
+        sink = sum;
+    }
+    benchmark_report("small reduce, threads started per call", benchmark_now() - start, SMALL_CALLS);
+    Vector_destroy(&small);
+    return 0;
+}
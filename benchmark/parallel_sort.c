@@ -0,0 +1,46 @@
+#include <stdlib.h>
+#include <unistd.h>
+#include "./benchmark.h"
+#include "../vector.h"
+
+// sorting 10M random ints with the timsort of Vector_sort and with Vector_sort_parallel on 1, 2, 4, ... threads,
+// up to twice the number of online processors (the speedup stops at the number of cores)
+#define LENGTH 10000000
+
+static int compare_ints(int a, int b) { return (a > b) - (a < b); }
+
+static int compare_int_ptrs(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+static int *make_vector(void) {
+    int *vec = Vector_init_with_capacity(int, LENGTH);
+    srand(42);
+    for (int i = 0; i < LENGTH; i++) { Vector_push(&vec, rand()); }
+    return vec;
+}
+
+int main(void) {
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    printf("sorting %d ints, %ld online processors\n", LENGTH, processors);
+
+    int *vec = make_vector();
+    double start = benchmark_now();
+    Vector_sort(&vec, compare_ints);
+    double serial = benchmark_now() - start;
+    benchmark_report("Vector_sort", serial, LENGTH);
+    Vector_destroy(&vec);
+
+    for (size_t threads = 1; threads <= (size_t)(processors > 1 ? 2 * processors : 2); threads *= 2) {
+        char label[64];
+        vec = make_vector();
+        start = benchmark_now();
+        Vector_sort_parallel(&vec, compare_int_ptrs, threads);
+        double elapsed = benchmark_now() - start;
+        snprintf(label, sizeof(label), "Vector_sort_parallel %zu threads (x%.2f)", threads, serial / elapsed);
+        benchmark_report(label, elapsed, LENGTH);
+        Vector_destroy(&vec);
+    }
+    return 0;
+}
@@ -0,0 +1,50 @@
+#include "./benchmark.h"
+#include "../vector.h"
+
+// sum of the halves of the even elements of a 16M element vector: Vector_filter -> Vector_map -> Vector_reduce against a fused pipeline
+#define LENGTH 16000000
+#define ROUNDS 4
+
+static bool is_even(int value) { return value % 2 == 0; }
+static double halve(int value) { return value / 2.0; }
+static double add(double accumulator, double value) { return accumulator + value; }
+
+static bool pipeline_is_even(const void *element, void *context) { (void)context; return is_even(*(const int *)element); }
+static void pipeline_halve(const void *element, void *result, void *context) { (void)context; *(double *)result = halve(*(const int *)element); }
+static void pipeline_add(void *accumulator, const void *element, void *context) { (void)context; *(double *)accumulator += *(const double *)element; }
+
+int main(void) {
+    printf("filter, map and reduce of %d elements, %d times\n", LENGTH, ROUNDS);
+    int *vec = Vector_init(int);
+    for (int i = 0; i < LENGTH; i++) { Vector_push(&vec, i); }
+    size_t count = (size_t)ROUNDS * LENGTH;
+
+    size_t intermediate_bytes = 0;
+    double start = benchmark_now();
+    for (int r = 0; r < ROUNDS; r++) {
+        int *evens = Vector_filter(&vec, is_even);
+        double *halves = Vector_map(&evens, halve, double);
+        benchmark_use(Vector_reduce(&halves, add, 0.0));
+        intermediate_bytes = Vector_get_capacity(&evens) * sizeof(int) + Vector_get_capacity(&halves) * sizeof(double);
+        Vector_destroy(&evens);
+        Vector_destroy(&halves);
+    }
+    benchmark_report("Vector_filter / map / reduce", benchmark_now() - start, count);
+    printf("    %-40s %10zu bytes of intermediate vectors per run\n", "", intermediate_bytes);
+
+    start = benchmark_now();
+    for (int r = 0; r < ROUNDS; r++) {
+        Vector_Pipeline pipeline;
+        Vector_pipeline_init(&pipeline, &vec);
+        Vector_pipeline_filter(&pipeline, pipeline_is_even, NULL);
+        Vector_pipeline_map(&pipeline, pipeline_halve, sizeof(double), NULL);
+        double sum = 0;
+        Vector_pipeline_reduce(&pipeline, pipeline_add, &sum, NULL);
+        benchmark_use(sum);
+    }
+    benchmark_report("Vector_pipeline_reduce", benchmark_now() - start, count);
+    printf("    %-40s %10d bytes of intermediate vectors per run\n", "", 0);
+
+    Vector_destroy(&vec);
+    return 0;
+}
@@ -0,0 +1,62 @@
+#include <pthread.h>
+#include "./benchmark.h"
+#include "../vector.h"
+
+// worker threads building and dropping small vectors (the default initial capacity growing to 8 and 16 elements)
+#define THREADS            4
+#define VECTORS_PER_THREAD 200000
+#define MAX_ELEMENTS       16
+
+// counts the calls reaching malloc for the baseline
+static size_t malloc_calls = 0;
+
+static void *counting_alloc(void *context, size_t size) {
+    (void)context;
+    __atomic_fetch_add(&malloc_calls, 1, __ATOMIC_RELAXED);
+    return malloc(size);
+}
+
+static void *counting_realloc(void *context, void *ptr, size_t old_size, size_t new_size) {
+    (void)context; (void)old_size;
+    __atomic_fetch_add(&malloc_calls, 1, __ATOMIC_RELAXED);
+    return realloc(ptr, new_size);
+}
+
+static void counting_free(void *context, void *ptr, size_t size) {
+    (void)context; (void)size;
+    free(ptr);
+}
+
+static const Vector_Allocator counting_allocator = { counting_alloc, counting_realloc, counting_free, NULL };
+
+static void *worker(void *arg) {
+    unsigned seed = (unsigned)(size_t)arg;
+    for (int v = 0; v < VECTORS_PER_THREAD; v++) {
+        int *vec = Vector_init(int);
+        seed = seed * 1103515245u + 12345u;
+        int length = (int)(seed >> 16) % MAX_ELEMENTS + 1;
+        for (int i = 0; i < length; i++) { Vector_push(&vec, i); }
+        benchmark_use(vec[length - 1]);
+        Vector_destroy(&vec);
+    }
+    return NULL;
+}
+
+static void run(const char *name, const Vector_Allocator *allocator) {
+    pthread_t threads[THREADS];
+    Vector_set_default_allocator(allocator);
+    double start = benchmark_now();
+    for (size_t t = 0; t < THREADS; t++) { pthread_create(&threads[t], NULL, worker, (void *)t); }
+    for (size_t t = 0; t < THREADS; t++) { pthread_join(threads[t], NULL); }
+    benchmark_report(name, benchmark_now() - start, THREADS * VECTORS_PER_THREAD);
+}
+
+int main(void) {
+    printf("%d threads, %d vectors of 1 to %d ints each\n", THREADS, VECTORS_PER_THREAD, MAX_ELEMENTS);
+    run("malloc", &counting_allocator);
+    printf("    %-40s %10zu malloc/realloc calls\n", "", malloc_calls);
+    run("thread local pool", &Vector_pool_allocator);
+    printf("    %-40s %10zu malloc/realloc calls\n", "", Vector_pool_get_malloc_count());
+    Vector_set_default_allocator(NULL);
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include "./benchmark.h"
+#include "../vector.h"
+
+// map, filter and slice of a 1M element vector, against building the result with Vector_push as they used to
+#define LENGTH 1000000
+#define ROUNDS 20
+
+static int twice(int value) { return value * 2; }
+static bool is_even(int value) { return value % 2 == 0; }
+
+int main(void) {
+    printf("map, filter and slice of %d elements, %d times\n", LENGTH, ROUNDS);
+    int *vec = Vector_init(int);
+    for (int i = 0; i < LENGTH; i++) { Vector_push(&vec, i); }
+    size_t count = (size_t)ROUNDS * LENGTH;
+
+    double start = benchmark_now();
+    for (int r = 0; r < ROUNDS; r++) {
+        int *result = Vector_init(int);
+        for (size_t i = 0; i < Vector_get_length(&vec); i++) { Vector_push(&result, twice(vec[i])); }
+        benchmark_use(result[LENGTH - 1]);
+        Vector_destroy(&result);
+    }
+    benchmark_report("map with Vector_push", benchmark_now() - start, count);
+
+    start = benchmark_now();
+    for (int r = 0; r < ROUNDS; r++) {
+        int *result = Vector_map(&vec, twice, int);
+        benchmark_use(result[LENGTH - 1]);
+        Vector_destroy(&result);
+    }
+    benchmark_report("Vector_map", benchmark_now() - start, count);
+
+    start = benchmark_now();
+    for (int r = 0; r < ROUNDS; r++) {
+        int *result = Vector_init(int);
+        for (size_t i = 0; i < Vector_get_length(&vec); i++) { if (is_even(vec[i])) { Vector_push(&result, vec[i]); } }
+        benchmark_use(result[0]);
+        Vector_destroy(&result);
+    }
+    benchmark_report("filter with Vector_push", benchmark_now() - start, count);
+
+    start = benchmark_now();
+    for (int r = 0; r < ROUNDS; r++) {
+        int *result = Vector_filter(&vec, is_even);
+        benchmark_use(result[0]);
+        Vector_destroy(&result);
+    }
+    benchmark_report("Vector_filter", benchmark_now() - start, count);
+
+    start = benchmark_now();
+    for (int r = 0; r < ROUNDS; r++) {
+        int *result = Vector_init(int);
+        for (size_t i = 0; i < LENGTH; i++) { Vector_push(&result, vec[i]); }
+        benchmark_use(result[0]);
+        Vector_destroy(&result);
+    }
+    benchmark_report("slice with Vector_push", benchmark_now() - start, count);
+
+    start = benchmark_now();
+    for (int r = 0; r < ROUNDS; r++) {
+        int *result = Vector_slice(&vec, 0, LENGTH, 1);
+        benchmark_use(result[0]);
+        Vector_destroy(&result);
+    }
+    benchmark_report("Vector_slice", benchmark_now() - start, count);
+
+    Vector_destroy(&vec);
+    return 0;
+}
@@ -0,0 +1,51 @@
+#include "./benchmark.h"
+#include "../vector.h"
+
+// many short append loops on cache resident vectors, so the cost of the push itself is measured instead of page faults
+#define LENGTH 4096
+#define ROUNDS 5000
+#define COUNT  ((size_t)LENGTH * ROUNDS)
+
+// the Vector_push macro as it was before the inline fast path:
+// out of line resize check (and optimal capacity calculation) on every push, plus a checked header lookup
+#define legacy_push(__vec_ptr__, __value__) do {                      \
+    assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");       \
+    __vector_resize_if_needed((__vec_ptr__));                         \
+    __Vector_Header *__header__ = __vector_get_header((__vec_ptr__)); \
+    (*(__vec_ptr__))[__header__->length++] = (__value__);             \
+} while (0)
+
+int main(void) {
+    printf("pushing %d ints into a fresh vector, %d times\n", LENGTH, ROUNDS);
+    long checksum_legacy = 0, checksum_fast = 0;
+
+    double start = benchmark_now();
+    for (int round = 0; round < ROUNDS; round++) {
+        int *vec = Vector_init(int);
+        for (int i = 0; i < LENGTH; i++) { legacy_push(&vec, i); }
+        checksum_legacy += vec[round % LENGTH];
+        Vector_destroy(&vec);
+    }
+    benchmark_report("legacy Vector_push", benchmark_now() - start, COUNT);
+
+    start = benchmark_now();
+    for (int round = 0; round < ROUNDS; round++) {
+        int *vec = Vector_init(int);
+        for (int i = 0; i < LENGTH; i++) { Vector_push(&vec, i); }
+        checksum_fast += vec[round % LENGTH];
+        Vector_destroy(&vec);
+    }
+    benchmark_report("Vector_push (inline fast path)", benchmark_now() - start, COUNT);
+
+    int *raw = (int *)malloc(LENGTH * sizeof(int));
+    start = benchmark_now();
+    for (int round = 0; round < ROUNDS; round++) {
+        for (int i = 0; i < LENGTH; i++) { raw[i] = i + round; }
+        benchmark_use(raw);
+    }
+    benchmark_report("raw presized array store", benchmark_now() - start, COUNT);
+    free(raw);
+
+    if (checksum_legacy != checksum_fast) { printf("checksum mismatch\n"); return 1; }
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include "./benchmark.h"
+#include "../vector.h"
+
+// sorting random 32 bit ints with the timsort of Vector_sort and the radix sort of Vector_sort_radix at 1M, 10M and 100M elements,
+// and 2M records by a 64 bit timestamp with Vector_sort and Vector_sort_radix_by_key
+#define RECORDS 2000000
+
+typedef struct Event {
+    int64_t timestamp;
+    char payload[24];
+} Event;
+
+static int compare_ints(int32_t a, int32_t b) { return (a > b) - (a < b); }
+static int compare_events(Event a, Event b) { return (a.timestamp > b.timestamp) - (a.timestamp < b.timestamp); }
+static const void *event_timestamp(const void *event) { return &((const Event *)event)->timestamp; }
+
+static int32_t *make_ints(size_t length) {
+    int32_t *vec = Vector_init_with_capacity(int32_t, length);
+    srand(42);
+    for (size_t i = 0; i < length; i++) { Vector_push(&vec, (int32_t)(rand() - RAND_MAX / 2)); }
+    return vec;
+}
+
+static Event *make_events(void) {
+    Event *vec = Vector_init(Event);
+    srand(42);
+    for (int i = 0; i < RECORDS; i++) {
+        Event event;
+        event.timestamp = 1700000000000LL + rand() % 86400000; // a day of milliseconds
+        event.payload[0] = (char)i;
+        Vector_push(&vec, event);
+    }
+    return vec;
+}
+
+int main(void) {
+    size_t lengths[] = { 1000000, 10000000, 100000000 };
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(*lengths); i++) {
+        char label[64];
+        printf("sorting %zu ints\n", lengths[i]);
+
+        int32_t *ints = make_ints(lengths[i]);
+        double start = benchmark_now();
+        Vector_sort(&ints, compare_ints);
+        snprintf(label, sizeof(label), "Vector_sort %zuM ints", lengths[i] / 1000000);
+        benchmark_report(label, benchmark_now() - start, lengths[i]);
+        Vector_destroy(&ints);
+
+        ints = make_ints(lengths[i]);
+        start = benchmark_now();
+        Vector_sort_radix(&ints, VECTOR_SCALAR_I32);
+        snprintf(label, sizeof(label), "Vector_sort_radix %zuM ints", lengths[i] / 1000000);
+        benchmark_report(label, benchmark_now() - start, lengths[i]);
+        Vector_destroy(&ints);
+    }
+
+    printf("sorting %d events of %zu bytes by timestamp\n", RECORDS, sizeof(Event));
+    Event *events = make_events();
+    double start = benchmark_now();
+    Vector_sort(&events, compare_events);
+    benchmark_report("Vector_sort events", benchmark_now() - start, RECORDS);
+    Vector_destroy(&events);
+
+    events = make_events();
+    start = benchmark_now();
+    Vector_sort_radix_by_key(&events, VECTOR_SCALAR_I64, event_timestamp);
+    benchmark_report("Vector_sort_radix_by_key events", benchmark_now() - start, RECORDS);
+    Vector_destroy(&events);
+    return 0;
+}
@@ -0,0 +1,33 @@
+#include "./benchmark.h"
+#include "../vector.h"
+
+// inserting then removing a block of contiguous elements in the middle of a vector, one element at a time and as a range
+#define LENGTH 65536
+#define BLOCK  256
+#define ROUNDS 50
+
+int main(void) {
+    printf("inserting and removing %d elements in the middle of %d elements, %d times\n", BLOCK, LENGTH, ROUNDS);
+    int *vec = Vector_init(int);
+    for (int i = 0; i < LENGTH; i++) { Vector_push(&vec, i); }
+    int block[BLOCK];
+    for (int i = 0; i < BLOCK; i++) { block[i] = -i; }
+    size_t count = (size_t)ROUNDS * BLOCK * 2;
+
+    double start = benchmark_now();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (int i = 0; i < BLOCK; i++) { Vector_insert_at(&vec, LENGTH / 2 + i, block[i]); }
+        for (int i = 0; i < BLOCK; i++) { benchmark_use(Vector_remove_at(&vec, LENGTH / 2)); }
+    }
+    benchmark_report("Vector_insert_at / Vector_remove_at", benchmark_now() - start, count);
+
+    start = benchmark_now();
+    for (int r = 0; r < ROUNDS; r++) {
+        Vector_insert_range(&vec, LENGTH / 2, block, BLOCK);
+        Vector_remove_range(&vec, LENGTH / 2, BLOCK, block);
+    }
+    benchmark_report("Vector_insert_range / Vector_remove_range", benchmark_now() - start, count);
+
+    Vector_destroy(&vec);
+    return 0;
+}
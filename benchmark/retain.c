@@ -0,0 +1,32 @@
+#include "./benchmark.h"
+#include "../vector.h"
+
+// dropping every third element of a vector, removing the matches one at a time and compacting in a single pass
+#define LENGTH 100000
+
+static bool is_multiple_of_three(int value) { return value % 3 == 0; }
+
+static int *make_vector(void) {
+    int *vec = Vector_init(int);
+    for (int i = 0; i < LENGTH; i++) { Vector_push(&vec, i); }
+    return vec;
+}
+
+int main(void) {
+    printf("removing the multiples of 3 from %d elements\n", LENGTH);
+
+    int *vec = make_vector();
+    double start = benchmark_now();
+    for (size_t i = Vector_get_length(&vec); i-- > 0;) {
+        if (is_multiple_of_three(vec[i])) { benchmark_use(Vector_remove_at(&vec, i)); }
+    }
+    benchmark_report("Vector_remove_at per match", benchmark_now() - start, LENGTH);
+    Vector_destroy(&vec);
+
+    vec = make_vector();
+    start = benchmark_now();
+    benchmark_use(Vector_remove_if(&vec, is_multiple_of_three));
+    benchmark_report("Vector_remove_if", benchmark_now() - start, LENGTH);
+    Vector_destroy(&vec);
+    return 0;
+}
@@ -0,0 +1,49 @@
+#include "./benchmark.h"
+#include "../vector.h"
+
+// merging per-shard result vectors into one, as a query fan-out does
+#define SHARDS       64
+#define SHARD_LENGTH 16384
+#define ROUNDS       20
+
+// Vector_concat as it was before the bulk append: a Vector_push per element
+#define legacy_concat(__vec_ptr1__, __vec_ptr2__) do {                           \
+    for (size_t __i__ = 0; __i__ < Vector_get_length((__vec_ptr2__)); __i__++) { \
+        Vector_push((__vec_ptr1__), (*(__vec_ptr2__))[__i__]);                   \
+    }                                                                            \
+} while (0)
+
+int main(void) {
+    printf("merging %d shards of %d ints, %d times\n", SHARDS, SHARD_LENGTH, ROUNDS);
+    int *shards[SHARDS];
+    for (int s = 0; s < SHARDS; s++) {
+        shards[s] = Vector_init(int);
+        for (int i = 0; i < SHARD_LENGTH; i++) { Vector_push(&shards[s], s + i); }
+    }
+    size_t count = (size_t)SHARDS * SHARD_LENGTH * ROUNDS;
+
+    size_t resizes_before = Vector_get_resize_count();
+    double start = benchmark_now();
+    for (int r = 0; r < ROUNDS; r++) {
+        int *merged = Vector_init(int);
+        for (int s = 0; s < SHARDS; s++) { legacy_concat(&merged, &shards[s]); }
+        benchmark_use(merged[r]);
+        Vector_destroy(&merged);
+    }
+    benchmark_report("Vector_push loop", benchmark_now() - start, count);
+    printf("    %-40s %10zu resizes\n", "", Vector_get_resize_count() - resizes_before);
+
+    resizes_before = Vector_get_resize_count();
+    start = benchmark_now();
+    for (int r = 0; r < ROUNDS; r++) {
+        int *merged = Vector_init(int);
+        for (int s = 0; s < SHARDS; s++) { Vector_concat(&merged, &shards[s]); }
+        benchmark_use(merged[r]);
+        Vector_destroy(&merged);
+    }
+    benchmark_report("Vector_concat", benchmark_now() - start, count);
+    printf("    %-40s %10zu resizes\n", "", Vector_get_resize_count() - resizes_before);
+
+    for (int s = 0; s < SHARDS; s++) { Vector_destroy(&shards[s]); }
+    return 0;
+}
@@ -0,0 +1,63 @@
+#include <stdlib.h>
+#include "./benchmark.h"
+#include "../vector.h"
+
+// sorting random ints and 56 byte structs with the timsort of Vector_sort and the introsort of Vector_sort_unstable
+#define INTS    10000000
+#define RECORDS 2000000
+
+typedef struct Record {
+    long key;
+    char payload[48];
+} Record;
+
+static int compare_ints(int a, int b) { return (a > b) - (a < b); }
+static int compare_records(Record a, Record b) { return (a.key > b.key) - (a.key < b.key); }
+
+static int *make_ints(void) {
+    int *vec = Vector_init(int);
+    srand(42);
+    for (int i = 0; i < INTS; i++) { Vector_push(&vec, rand()); }
+    return vec;
+}
+
+static Record *make_records(void) {
+    Record *vec = Vector_init(Record);
+    srand(42);
+    for (int i = 0; i < RECORDS; i++) {
+        Record record;
+        record.key = rand();
+        record.payload[0] = (char)i;
+        Vector_push(&vec, record);
+    }
+    return vec;
+}
+
+int main(void) {
+    printf("sorting %d ints and %d records of %zu bytes\n", INTS, RECORDS, sizeof(Record));
+
+    int *ints = make_ints();
+    double start = benchmark_now();
+    Vector_sort(&ints, compare_ints);
+    benchmark_report("Vector_sort ints", benchmark_now() - start, INTS);
+    Vector_destroy(&ints);
+
+    ints = make_ints();
+    start = benchmark_now();
+    Vector_sort_unstable(&ints, compare_ints);
+    benchmark_report("Vector_sort_unstable ints", benchmark_now() - start, INTS);
+    Vector_destroy(&ints);
+
+    Record *records = make_records();
+    start = benchmark_now();
+    Vector_sort(&records, compare_records);
+    benchmark_report("Vector_sort records", benchmark_now() - start, RECORDS);
+    Vector_destroy(&records);
+
+    records = make_records();
+    start = benchmark_now();
+    Vector_sort_unstable(&records, compare_records);
+    benchmark_report("Vector_sort_unstable records", benchmark_now() - start, RECORDS);
+    Vector_destroy(&records);
+    return 0;
+}
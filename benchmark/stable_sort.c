@@ -0,0 +1,84 @@
+#include <stdlib.h>
+#include "./benchmark.h"
+#include "../vector.h"
+
+// stable sorting of 2M ints, random and nearly sorted (sorted with 1% of the elements changed), with the bottom-up merge sort
+// Vector_sort used before (copied below, it allocates two arrays per merge) and with the current timsort
+#define LENGTH 2000000
+
+#define legacy_merge(__arr__, __left_size__, __mid__, __right_size__, __ordering_comparator__, __allocator__) do {                 \
+    int __i__, __j__, __k__;                                                                                                       \
+    int __n1__ = (__mid__) - (__left_size__) + 1;                                                                                  \
+    int __n2__ =  (__right_size__) - (__mid__);                                                                                    \
+    typeof(*(__arr__)) *__left_array__ = (typeof(__arr__))__vector_allocator_alloc((__allocator__), __n1__ * sizeof(*(__arr__)));  \
+    typeof(*(__arr__)) *__right_array__ = (typeof(__arr__))__vector_allocator_alloc((__allocator__), __n2__ * sizeof(*(__arr__))); \
+    for (__i__ = 0; __i__ < __n1__; __i__++) {                                                                                     \
+        __left_array__[__i__] = (__arr__)[(__left_size__) + __i__];                                                                \
+    }                                                                                                                              \
+    for (__j__ = 0; __j__ < __n2__; __j__++) {                                                                                     \
+        __right_array__[__j__] = (__arr__)[(__mid__) + 1 + __j__];                                                                 \
+    }                                                                                                                              \
+    __i__ = 0; __j__ = 0; __k__ = (__left_size__);                                                                                 \
+    while (__i__ < __n1__ && __j__ < __n2__) {                                                                                     \
+        if ((__ordering_comparator__)(__left_array__[__i__], __right_array__[__j__]) <= 0) {                                       \
+            (__arr__)[__k__++] = __left_array__[__i__++];                                                                          \
+        } else {                                                                                                                   \
+            (__arr__)[__k__++] = __right_array__[__j__++];                                                                         \
+        }                                                                                                                          \
+    }                                                                                                                              \
+    while (__i__ < __n1__) {                                                                                                       \
+        (__arr__)[__k__++] = __left_array__[__i__++];                                                                              \
+    }                                                                                                                              \
+    while (__j__ < __n2__) {                                                                                                       \
+        (__arr__)[__k__++] = __right_array__[__j__++];                                                                             \
+    }                                                                                                                              \
+    __vector_allocator_free((__allocator__), __left_array__, __n1__ * sizeof(*(__arr__)));                                         \
+    __vector_allocator_free((__allocator__), __right_array__, __n2__ * sizeof(*(__arr__)));                                        \
+} while(0)
+
+#define legacy_merge_sort(__arr__, __n__, __ordering_comparator__, __allocator__) do {                                               \
+    int __curr_size__, __left_start__;                                                                                               \
+    for (__curr_size__ = 1; __curr_size__ <= (__n__) - 1; __curr_size__ = 2 * __curr_size__) {                                       \
+        for (__left_start__ = 0; __left_start__ < (__n__) - 1; __left_start__ += 2 * __curr_size__) {                                \
+            int __mid__ = __left_start__ + __curr_size__ < (__n__) ? __left_start__ + __curr_size__ - 1 : (__n__) - 1;               \
+            int __right_end__ = __left_start__ + 2 * __curr_size__ < (__n__) ? __left_start__ + 2 * __curr_size__ - 1 : (__n__) - 1; \
+            legacy_merge((__arr__), __left_start__, __mid__, __right_end__, (__ordering_comparator__), (__allocator__));             \
+        }                                                                                                                            \
+    }                                                                                                                                \
+} while(0)
+
+static int compare_ints(int a, int b) { return (a > b) - (a < b); }
+
+static int *make_vector(bool nearly_sorted) {
+    int *vec = Vector_init(int);
+    srand(42);
+    for (int i = 0; i < LENGTH; i++) { Vector_push(&vec, nearly_sorted ? i : rand()); }
+    if (nearly_sorted) {
+        for (int i = 0; i < LENGTH / 100; i++) { vec[rand() % LENGTH] = rand() % LENGTH; }
+    }
+    return vec;
+}
+
+static void run(const char *name, bool nearly_sorted) {
+    char label[64];
+    int *vec = make_vector(nearly_sorted);
+    double start = benchmark_now();
+    legacy_merge_sort(vec, LENGTH, compare_ints, &Vector_malloc_allocator);
+    snprintf(label, sizeof(label), "merge sort, %s", name);
+    benchmark_report(label, benchmark_now() - start, LENGTH);
+    Vector_destroy(&vec);
+
+    vec = make_vector(nearly_sorted);
+    start = benchmark_now();
+    Vector_sort(&vec, compare_ints);
+    snprintf(label, sizeof(label), "Vector_sort, %s", name);
+    benchmark_report(label, benchmark_now() - start, LENGTH);
+    Vector_destroy(&vec);
+}
+
+int main(void) {
+    printf("stable sorting of %d ints\n", LENGTH);
+    run("random", false);
+    run("nearly sorted", true);
+    return 0;
+}
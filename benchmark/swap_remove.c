@@ -0,0 +1,43 @@
+#include <stdlib.h>
+#include "./benchmark.h"
+#include "../vector.h"
+
+// removing random elements from a vector of 1M elements whose order does not matter
+#define LENGTH   1000000
+#define REMOVALS 10000
+
+static int *make_vector(void) {
+    int *vec = Vector_init(int);
+    for (int i = 0; i < LENGTH; i++) { Vector_push(&vec, i); }
+    return vec;
+}
+
+int main(void) {
+    printf("removing %d random elements from %d elements\n", REMOVALS, LENGTH);
+    srand(42);
+    size_t *indices = (size_t *)malloc(REMOVALS * sizeof(size_t));
+    for (int i = 0; i < REMOVALS; i++) { indices[i] = (size_t)rand() % (LENGTH - REMOVALS); }
+
+    int *vec = make_vector();
+    double start = benchmark_now();
+    for (int i = 0; i < REMOVALS; i++) { benchmark_use(Vector_remove_at(&vec, indices[i])); }
+    benchmark_report("Vector_remove_at", benchmark_now() - start, REMOVALS);
+    Vector_destroy(&vec);
+
+    vec = make_vector();
+    start = benchmark_now();
+    for (int i = 0; i < REMOVALS; i++) { benchmark_use(Vector_swap_remove(&vec, indices[i])); }
+    benchmark_report("Vector_swap_remove", benchmark_now() - start, REMOVALS);
+    Vector_destroy(&vec);
+
+    // the batch form takes distinct indices
+    for (int i = 0; i < REMOVALS; i++) { indices[i] = (size_t)i * (LENGTH / REMOVALS) + (size_t)rand() % (LENGTH / REMOVALS); }
+    vec = make_vector();
+    start = benchmark_now();
+    Vector_swap_remove_indices(&vec, indices, REMOVALS);
+    benchmark_report("Vector_swap_remove_indices", benchmark_now() - start, REMOVALS);
+    Vector_destroy(&vec);
+
+    free(indices);
+    return 0;
+}
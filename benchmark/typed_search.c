@@ -0,0 +1,59 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include "./benchmark.h"
+#include "../vector.h"
+
+// searching and counting in 16M int32 and 64M bytes: Vector_index_of/Vector_count with a comparator against the typed
+// Vector_find_eq/Vector_count_eq/Vector_count_range (the searched value is the last element, every element is read)
+#define INTS  16000000
+#define BYTES 64000000
+#define REPEATS 5
+
+static bool equal_ints(int32_t value_in_vec, int32_t value) { return value_in_vec == value; }
+static bool equal_bytes(uint8_t value_in_vec, uint8_t value) { return value_in_vec == value; }
+
+static volatile size_t sink;
+
+int main(void) {
+    printf("searching %d int32 and %d bytes, %d times each\n", INTS, BYTES, REPEATS);
+    int32_t *ints = Vector_init_with_capacity(int32_t, INTS);
+    srand(42);
+    for (int i = 0; i < INTS - 1; i++) { Vector_push(&ints, rand() % 1000); }
+    Vector_push(&ints, -1);
+    int32_t needle = -1, low = 100, high = 199;
+
+    double start = benchmark_now();
+    for (int r = 0; r < REPEATS; r++) { sink = Vector_index_of(&ints, needle, equal_ints); }
+    benchmark_report("Vector_index_of int32", benchmark_now() - start, (size_t)INTS * REPEATS);
+    start = benchmark_now();
+    for (int r = 0; r < REPEATS; r++) { sink = Vector_find_eq(&ints, VECTOR_SCALAR_I32, &needle); }
+    benchmark_report("Vector_find_eq int32", benchmark_now() - start, (size_t)INTS * REPEATS);
+
+    start = benchmark_now();
+    for (int r = 0; r < REPEATS; r++) { sink = Vector_count(&ints, needle, equal_ints); }
+    benchmark_report("Vector_count int32", benchmark_now() - start, (size_t)INTS * REPEATS);
+    start = benchmark_now();
+    for (int r = 0; r < REPEATS; r++) { sink = Vector_count_eq(&ints, VECTOR_SCALAR_I32, &needle); }
+    benchmark_report("Vector_count_eq int32", benchmark_now() - start, (size_t)INTS * REPEATS);
+    start = benchmark_now();
+    for (int r = 0; r < REPEATS; r++) { sink = Vector_count_range(&ints, VECTOR_SCALAR_I32, &low, &high); }
+    benchmark_report("Vector_count_range int32", benchmark_now() - start, (size_t)INTS * REPEATS);
+    Vector_destroy(&ints);
+
+    uint8_t *bytes = Vector_init_with_capacity(uint8_t, BYTES);
+    for (int i = 0; i < BYTES - 1; i++) { Vector_push(&bytes, (uint8_t)(rand() % 255)); }
+    Vector_push(&bytes, 255);
+    uint8_t byte_needle = 255;
+
+    start = benchmark_now();
+    for (int r = 0; r < REPEATS; r++) { sink = Vector_index_of(&bytes, byte_needle, equal_bytes); }
+    benchmark_report("Vector_index_of bytes", benchmark_now() - start, (size_t)BYTES * REPEATS);
+    start = benchmark_now();
+    for (int r = 0; r < REPEATS; r++) { sink = Vector_find_eq(&bytes, VECTOR_SCALAR_U8, &byte_needle); }
+    benchmark_report("Vector_find_eq bytes (memchr)", benchmark_now() - start, (size_t)BYTES * REPEATS);
+    start = benchmark_now();
+    for (int r = 0; r < REPEATS; r++) { sink = Vector_count_eq(&bytes, VECTOR_SCALAR_U8, &byte_needle); }
+    benchmark_report("Vector_count_eq bytes", benchmark_now() - start, (size_t)BYTES * REPEATS);
+    Vector_destroy(&bytes);
+    return 0;
+}
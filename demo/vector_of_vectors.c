@@ -32,7 +32,7 @@ void free_fn(void *vec_ptr) {
         int *v = (*temp_vec)[i];
         Vector_destroy(&v);
     }
-    free(__vector_get_header(temp_vec));
+    Vector_deallocate(temp_vec);
 }
 
 int main(void) {
@@ -1,8 +1,22 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+    #define _GNU_SOURCE // mremap
+#endif // defined(__linux__) && !defined(_GNU_SOURCE)
+
 #include <stdio.h>
+#include <stdint.h>
+#if defined(__linux__)
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif // defined(__linux__)
 
 #include "./vector.h"
 #include "./modules/system_env/system_env.h"
 #include "./modules/assertf/assertf.h"
+#if VECTOR_THREADS
+    #include <pthread.h>
+    #include <sched.h>
+    #include <unistd.h>
+#endif // VECTOR_THREADS
 
 
 __Vector_Header *__vector_get_header(void *vec_ptr) {
@@ -12,25 +26,422 @@ __Vector_Header *__vector_get_header(void *vec_ptr) {
     return (__Vector_Header *)(((char *)*temp_ptr) - sizeof(__Vector_Header));
 }
 
+static void *__vector_malloc_alloc(void *context, size_t size) {
+    (void)context;
+    return malloc(size);
+}
+
+static void *__vector_malloc_realloc(void *context, void *ptr, size_t old_size, size_t new_size) {
+    (void)context; (void)old_size;
+    return realloc(ptr, new_size);
+}
+
+static void __vector_malloc_free(void *context, void *ptr, size_t size) {
+    (void)context; (void)size;
+    free(ptr);
+}
+
+const Vector_Allocator Vector_malloc_allocator = { __vector_malloc_alloc, __vector_malloc_realloc, __vector_malloc_free, NULL };
+
+#if LANGUAGE_CPP
+    #define __VECTOR_THREAD_LOCAL thread_local
+    #define __VECTOR_MAX_ALIGNMENT alignof(max_align_t)
+#else // LANGUAGE_CPP
+    #define __VECTOR_THREAD_LOCAL _Thread_local
+    #define __VECTOR_MAX_ALIGNMENT _Alignof(max_align_t)
+#endif // LANGUAGE_CPP
+
+static const Vector_Allocator *__vector_default_allocator = &Vector_malloc_allocator;
+// the allocator of the innermost arena scope of the thread, NULL outside of any scope
+static __VECTOR_THREAD_LOCAL const Vector_Allocator *__vector_scope_allocator = NULL;
+// the allocators of the enclosing scopes of the thread, restored by Vector_arena_end_scope
+#define __VECTOR_ARENA_MAX_SCOPE_DEPTH 64
+static __VECTOR_THREAD_LOCAL const Vector_Allocator *__vector_scope_stack[__VECTOR_ARENA_MAX_SCOPE_DEPTH];
+static __VECTOR_THREAD_LOCAL size_t __vector_scope_depth = 0;
+
+void *__vector_allocator_alloc(const Vector_Allocator *allocator, size_t size) {
+    void *ptr = allocator->alloc_fn(allocator->context, size);
+    assertf(ptr != NULL, "ERROR: Memory allocation failed\n");
+    return ptr;
+}
+
+void __vector_allocator_free(const Vector_Allocator *allocator, void *ptr, size_t size) {
+    allocator->free_fn(allocator->context, ptr, size);
+}
+
+const Vector_Allocator *__vector_derived_allocator(const Vector_Allocator *allocator) {
+    #if defined(__linux__)
+        // a huge vector does not make its derived vectors and scratch buffers huge, each mapping would reserve address space of its own
+        if (allocator == &Vector_mmap_allocator) {
+            allocator = Vector_get_default_allocator();
+            if (allocator == &Vector_mmap_allocator) { allocator = &Vector_malloc_allocator; }
+        }
+    #endif // defined(__linux__)
+    return allocator;
+}
+
+/**
+ * Internal
+ * 
+ * Returns the number of bytes of the header and `count` elements
+ * @param header [__Vector_Header*] - The header of the vector
+ * @param count  [size_t]           - The number of elements
+ * @return       [size_t]           - The size of the header and the elements
+ */
+static size_t __vector_payload_size(const __Vector_Header *header, size_t count) {
+    return sizeof(__Vector_Header) + count * __VECTOR_TRAIT(header, element_size);
+}
+
+/**
+ * Internal
+ * 
+ * Returns the number of bytes of the block holding the header and `capacity` elements,
+ * an alignment stricter than max_align_t adds the padding the header may need to be moved by
+ * @param header   [__Vector_Header*] - The header of the vector
+ * @param capacity [size_t]           - The capacity of the vector
+ * @return         [size_t]           - The size of the block
+ */
+static size_t __vector_block_size(const __Vector_Header *header, size_t capacity) {
+    size_t padding = __VECTOR_TRAIT(header, alignment) > __VECTOR_MAX_ALIGNMENT ? __VECTOR_TRAIT(header, alignment) - __VECTOR_MAX_ALIGNMENT : 0;
+    return padding + __vector_payload_size(header, capacity);
+}
+
+/**
+ * Internal
+ * 
+ * Returns the start of the block holding a vector (the header is `header_offset` bytes into it)
+ * @param header [__Vector_Header*] - The header of the vector
+ * @return       [void*]            - The block given by the allocator
+ */
+static void *__vector_block(const __Vector_Header *header) {
+    return (char *)header - header->header_offset;
+}
+
+/**
+ * Internal
+ * 
+ * Returns where the header goes in a block so that the data is aligned
+ * @param block     [void*]  - A block from an allocator, aligned for max_align_t
+ * @param alignment [size_t] - The alignment of the data, a power of two
+ * @return          [size_t] - The offset of the header in the block
+ */
+static size_t __vector_header_offset(const void *block, size_t alignment) {
+    uintptr_t data = (uintptr_t)block + sizeof(__Vector_Header);
+    return (size_t)((alignment - data % alignment) % alignment);
+}
+
+/**
+ * Internal
+ * 
+ * Copies the header and the elements of a vector into a new block, at the offset aligning the data
+ * @param src   [__Vector_Header*] - The header of the vector
+ * @param block [void*]            - The new block, at least __vector_block_size(src, src->length) bytes
+ * @return      [__Vector_Header*] - The header in the new block
+ */
+static __Vector_Header *__vector_copy_to_block(const __Vector_Header *src, void *block) {
+    size_t header_offset = __vector_header_offset(block, __VECTOR_TRAIT(src, alignment));
+    __Vector_Header *dst = (__Vector_Header *)((char *)block + header_offset);
+    memcpy(dst, src, __vector_payload_size(src, src->length));
+    dst->header_offset = header_offset;
+    dst->flags &= ~__VECTOR_FLAG_INLINE;
+    return dst;
+}
+
+// the shared counters, flags and locks are declared __VECTOR_ATOMIC(T) and only touched through these macros (or under a lock)
+#if defined(__GNUC__) || defined(__clang__)
+    #define __VECTOR_ATOMIC(__type__) __type__
+    #define __VECTOR_COUNTER_INCREMENT(__counter__) __atomic_fetch_add(&(__counter__), 1, __ATOMIC_RELAXED)
+    #define __VECTOR_COUNTER_LOAD(__counter__) __atomic_load_n(&(__counter__), __ATOMIC_RELAXED)
+    #define __VECTOR_LOAD_ACQUIRE(__variable__) __atomic_load_n(&(__variable__), __ATOMIC_ACQUIRE)
+    #define __VECTOR_STORE_RELEASE(__variable__, __value__) __atomic_store_n(&(__variable__), (__value__), __ATOMIC_RELEASE)
+    #define __VECTOR_EXCHANGE_ACQUIRE(__variable__, __value__) __atomic_exchange_n(&(__variable__), (__value__), __ATOMIC_ACQUIRE)
+    #define __VECTOR_REFERENCE_ADD(__count__) __atomic_fetch_add(&(__count__), 1, __ATOMIC_RELAXED)
+    #define __VECTOR_REFERENCE_DROP(__count__) __atomic_sub_fetch(&(__count__), 1, __ATOMIC_ACQ_REL)
+    #define __VECTOR_COMPARE_EXCHANGE(__variable__, __expected__, __desired__) __atomic_compare_exchange_n(&(__variable__), &(__expected__), (__desired__), false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)
+    #if defined(__x86_64__) || defined(__i386__)
+        #define __VECTOR_CPU_RELAX() __builtin_ia32_pause()
+    #elif defined(__aarch64__) || defined(__arm__)
+        #define __VECTOR_CPU_RELAX() __asm__ __volatile__("yield")
+    #else
+        #define __VECTOR_CPU_RELAX() ((void)0)
+    #endif
+    // forces a helper into each of its callers, so a constant argument (an element size) specializes its body
+    #define __VECTOR_ALWAYS_INLINE inline __attribute__((always_inline))
+#elif LANGUAGE_CPP
+    #include <atomic>
+    #define __VECTOR_ATOMIC(__type__) std::atomic<__type__>
+    #define __VECTOR_COUNTER_INCREMENT(__counter__) std::atomic_fetch_add_explicit(&(__counter__), (size_t)1, std::memory_order_relaxed)
+    #define __VECTOR_COUNTER_LOAD(__counter__) std::atomic_load_explicit(&(__counter__), std::memory_order_relaxed)
+    #define __VECTOR_LOAD_ACQUIRE(__variable__) std::atomic_load_explicit(&(__variable__), std::memory_order_acquire)
+    #define __VECTOR_STORE_RELEASE(__variable__, __value__) std::atomic_store_explicit(&(__variable__), (__value__), std::memory_order_release)
+    #define __VECTOR_EXCHANGE_ACQUIRE(__variable__, __value__) std::atomic_exchange_explicit(&(__variable__), (__value__), std::memory_order_acquire)
+    #define __VECTOR_REFERENCE_ADD(__count__) std::atomic_fetch_add_explicit(&(__count__), (size_t)1, std::memory_order_relaxed)
+    #define __VECTOR_REFERENCE_DROP(__count__) (std::atomic_fetch_sub_explicit(&(__count__), (size_t)1, std::memory_order_acq_rel) - 1)
+    #define __VECTOR_COMPARE_EXCHANGE(__variable__, __expected__, __desired__) std::atomic_compare_exchange_strong_explicit(&(__variable__), &(__expected__), (__desired__), std::memory_order_acq_rel, std::memory_order_relaxed)
+    #define __VECTOR_CPU_RELAX() ((void)0)
+    #define __VECTOR_ALWAYS_INLINE inline
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_ATOMICS__)
+    #include <stdatomic.h>
+    #define __VECTOR_ATOMIC(__type__) _Atomic(__type__)
+    #define __VECTOR_COUNTER_INCREMENT(__counter__) atomic_fetch_add_explicit(&(__counter__), 1, memory_order_relaxed)
+    #define __VECTOR_COUNTER_LOAD(__counter__) atomic_load_explicit(&(__counter__), memory_order_relaxed)
+    #define __VECTOR_LOAD_ACQUIRE(__variable__) atomic_load_explicit(&(__variable__), memory_order_acquire)
+    #define __VECTOR_STORE_RELEASE(__variable__, __value__) atomic_store_explicit(&(__variable__), (__value__), memory_order_release)
+    #define __VECTOR_EXCHANGE_ACQUIRE(__variable__, __value__) atomic_exchange_explicit(&(__variable__), (__value__), memory_order_acquire)
+    #define __VECTOR_REFERENCE_ADD(__count__) atomic_fetch_add_explicit(&(__count__), 1, memory_order_relaxed)
+    #define __VECTOR_REFERENCE_DROP(__count__) (atomic_fetch_sub_explicit(&(__count__), 1, memory_order_acq_rel) - 1)
+    #define __VECTOR_COMPARE_EXCHANGE(__variable__, __expected__, __desired__) atomic_compare_exchange_strong_explicit(&(__variable__), &(__expected__), (__desired__), memory_order_acq_rel, memory_order_relaxed)
+    #define __VECTOR_CPU_RELAX() ((void)0)
+    #define __VECTOR_ALWAYS_INLINE inline
+#elif VECTOR_THREADS
+    #error "vector.c needs GNU atomics, C11 <stdatomic.h> or C++11 <atomic> when VECTOR_THREADS is set, compile it with -DVECTOR_THREADS=0 otherwise"
+#else
+    // no atomics and no threads: the vectors are only used by a single thread
+    #define __VECTOR_ATOMIC(__type__) __type__
+    #define __VECTOR_COUNTER_INCREMENT(__counter__) ((__counter__)++)
+    #define __VECTOR_COUNTER_LOAD(__counter__) (__counter__)
+    #define __VECTOR_LOAD_ACQUIRE(__variable__) (__variable__)
+    #define __VECTOR_STORE_RELEASE(__variable__, __value__) ((__variable__) = (__value__))
+    #define __VECTOR_EXCHANGE_ACQUIRE(__variable__, __value__) __vector_exchange_int(&(__variable__), (__value__))
+    #define __VECTOR_REFERENCE_ADD(__count__) ((__count__)++)
+    #define __VECTOR_REFERENCE_DROP(__count__) (--(__count__))
+    #define __VECTOR_COMPARE_EXCHANGE(__variable__, __expected__, __desired__) ((__variable__) == (__expected__) ? ((__variable__) = (__desired__), true) : ((__expected__) = (__variable__), false))
+    #define __VECTOR_CPU_RELAX() ((void)0)
+    #define __VECTOR_ALWAYS_INLINE inline
+
+    static int __vector_exchange_int(int *variable, int value) {
+        int old = *variable;
+        *variable = value;
+        return old;
+    }
+#endif
+
+// a lock held for a few instructions, 0 when free (the static ones are left to zero initialization, std::atomic cannot be copy initialized before C++17)
+typedef __VECTOR_ATOMIC(int) __Vector_Spin_Lock;
+
+/**
+ * Internal
+ * 
+ * Takes a spin lock: waits on plain loads so the cache line is not bounced between the waiters,
+ * and gives the processor away after a while in case the holder is not running
+ * @param lock [__Vector_Spin_Lock*] - The lock
+ */
+static void __vector_spin_lock(__Vector_Spin_Lock *lock) {
+    unsigned int spins = 0;
+    while (__VECTOR_EXCHANGE_ACQUIRE(*lock, 1) != 0) {
+        while (__VECTOR_COUNTER_LOAD(*lock) != 0) {
+            if (++spins < 64) { __VECTOR_CPU_RELAX(); continue; }
+            spins = 0;
+            #if VECTOR_THREADS
+                sched_yield();
+            #endif // VECTOR_THREADS
+        }
+    }
+}
+
+#define __VECTOR_SPIN_LOCK(__lock__) __vector_spin_lock(&(__lock__))
+#define __VECTOR_SPIN_UNLOCK(__lock__) __VECTOR_STORE_RELEASE((__lock__), 0)
+
+// how many times __vector_realloc ran, and how many of those kept the block in place (no copy of the payload)
+static __VECTOR_ATOMIC(size_t) __vector_resize_count;
+static __VECTOR_ATOMIC(size_t) __vector_inplace_resize_count;
+
+#if VECTOR_COMPACT_HEADER
+    typedef struct __Vector_Traits_Node {
+        __Vector_Traits traits; // first, so a record is also its node
+        __VECTOR_ATOMIC(size_t) reference_count; // the vectors (and thread caches) pointing to the record, it is freed when the last one lets go
+        struct __Vector_Traits_Node *next;
+    } __Vector_Traits_Node;
+
+    // the live records, the most recently interned first, only walked and linked under the lock
+    // the lock is only taken to intern a record missing from the cache of the thread and to unlink a dead record,
+    // a vector taking or dropping a reference is a single atomic add
+    static __Vector_Traits_Node *__vector_traits_list = NULL;
+    static __Vector_Spin_Lock __vector_traits_lock;
+    // the record interned last on this thread, holding a reference of its own so it stays alive while cached:
+    // vectors are usually initialized many times with the same configuration
+    static __VECTOR_THREAD_LOCAL __Vector_Traits_Node *__vector_traits_cache = NULL;
+
+    /**
+     * Internal
+     * 
+     * Compares two traits records field by field
+     * @param a [__Vector_Traits*] - The first record
+     * @param b [__Vector_Traits*] - The second record
+     * @return  [bool]             - True if the records are equal
+     */
+    static bool __vector_traits_equal(const __Vector_Traits *a, const __Vector_Traits *b) {
+        return a->element_size == b->element_size
+            && a->initial_capacity == b->initial_capacity
+            && a->free_fn == b->free_fn
+            && a->element_free_fn == b->element_free_fn
+            && a->calculate_optimal_capacity_fn == b->calculate_optimal_capacity_fn
+            && a->allocator == b->allocator
+            && a->alignment == b->alignment;
+    }
+
+    /**
+     * Internal
+     * 
+     * Adds a reference to an interned record, for a new vector sharing the configuration of another
+     * @param traits [__Vector_Traits*] - The interned record, already referenced by the caller
+     */
+    static void __vector_retain_traits(const __Vector_Traits *traits) {
+        __VECTOR_REFERENCE_ADD(((__Vector_Traits_Node *)traits)->reference_count);
+    }
+
+    /**
+     * Internal
+     * 
+     * Drops a reference to an interned record, the record is unlinked and freed with its last reference
+     * a record at 0 references can no longer be found (__vector_intern_traits only takes a reference of a live record), so it is freed once
+     * @param traits [__Vector_Traits*] - The interned record
+     */
+    static void __vector_release_traits(const __Vector_Traits *traits) {
+        __Vector_Traits_Node *node = (__Vector_Traits_Node *)traits;
+        if (__VECTOR_REFERENCE_DROP(node->reference_count) != 0) { return; }
+        __VECTOR_SPIN_LOCK(__vector_traits_lock);
+        __Vector_Traits_Node **link = &__vector_traits_list;
+        while (*link != node) { link = &(*link)->next; }
+        *link = node->next;
+        __VECTOR_SPIN_UNLOCK(__vector_traits_lock);
+        free(node);
+    }
+
+    #if VECTOR_THREADS
+        static pthread_key_t __vector_traits_key;
+        static pthread_once_t __vector_traits_key_once = PTHREAD_ONCE_INIT;
+
+        /**
+         * Internal
+         * 
+         * Runs when a thread having a cached record exits, drops the reference of the cache
+         * @param arg [__Vector_Traits_Node*] - The cached record
+         */
+        static void __vector_traits_thread_exit(void *arg) {
+            __vector_traits_cache = NULL;
+            __vector_release_traits(&((__Vector_Traits_Node *)arg)->traits);
+        }
+
+        /**
+         * Internal
+         * 
+         * Creates the key whose destructor drops the cached record of an exiting thread, called once
+         */
+        static void __vector_traits_create_key(void) {
+            pthread_key_create(&__vector_traits_key, __vector_traits_thread_exit);
+        }
+    #endif // VECTOR_THREADS
+
+    /**
+     * Internal
+     * 
+     * Returns the interned record equal to `traits` with one more reference, interning a copy of it the first time
+     * @param traits [__Vector_Traits*] - The configuration to intern
+     * @return       [__Vector_Traits*] - The shared record, valid until its last reference is released
+     * @throw        [assert]           - If malloc fails
+     */
+    static const __Vector_Traits *__vector_intern_traits(const __Vector_Traits *traits) {
+        __Vector_Traits_Node *cached = __vector_traits_cache;
+        if (cached != NULL && __vector_traits_equal(&cached->traits, traits)) {
+            __VECTOR_REFERENCE_ADD(cached->reference_count);
+            return &cached->traits;
+        }
+        __VECTOR_SPIN_LOCK(__vector_traits_lock);
+        __Vector_Traits_Node **link = &__vector_traits_list;
+        __Vector_Traits_Node *node = NULL;
+        for (; *link != NULL; link = &(*link)->next) {
+            if (!__vector_traits_equal(&(*link)->traits, traits)) { continue; }
+            // a record whose last reference is being dropped is left to its releaser
+            size_t count = __VECTOR_COUNTER_LOAD((*link)->reference_count);
+            while (count != 0 && !__VECTOR_COMPARE_EXCHANGE((*link)->reference_count, count, count + 2)) {}
+            if (count == 0) { continue; }
+            node = *link;
+            *link = node->next;
+            break;
+        }
+        if (node == NULL) {
+            node = (__Vector_Traits_Node *)malloc(sizeof(__Vector_Traits_Node));
+            assertf(node != NULL, "ERROR: Memory allocation failed\n");
+            node->traits = *traits;
+            __VECTOR_STORE_RELEASE(node->reference_count, (size_t)2);
+        }
+        node->next = __vector_traits_list;
+        __vector_traits_list = node;
+        __VECTOR_SPIN_UNLOCK(__vector_traits_lock);
+        // one of the two references is the cache's, the previous record loses its own
+        __vector_traits_cache = node;
+        #if VECTOR_THREADS
+            pthread_once(&__vector_traits_key_once, __vector_traits_create_key);
+            pthread_setspecific(__vector_traits_key, node);
+        #endif // VECTOR_THREADS
+        if (cached != NULL) { __vector_release_traits(&cached->traits); }
+        return &node->traits;
+    }
+
+    // changes one field of the configuration of a vector, the vector moves to the record of its new configuration
+    #define __VECTOR_SET_TRAIT(__header__, __field__, __value__) do {   \
+        const __Vector_Traits *__old_traits__ = (__header__)->traits;   \
+        __Vector_Traits __traits__ = *__old_traits__;                   \
+        __traits__.__field__ = (__value__);                             \
+        (__header__)->traits = __vector_intern_traits(&__traits__);     \
+        __vector_release_traits(__old_traits__);                        \
+    } while (0)
+    // a new vector copied from the header of another one shares its record, a destroyed vector gives its reference back
+    #define __VECTOR_RETAIN_TRAITS(__header__) __vector_retain_traits((__header__)->traits)
+    #define __VECTOR_RELEASE_TRAITS(__header__) __vector_release_traits((__header__)->traits)
+#else // VECTOR_COMPACT_HEADER
+    // changes one field of the configuration of a vector
+    #define __VECTOR_SET_TRAIT(__header__, __field__, __value__) ((__header__)->__field__ = (__value__))
+    // the configuration lives in the header, nothing is shared
+    #define __VECTOR_RETAIN_TRAITS(__header__) ((void)(__header__))
+    #define __VECTOR_RELEASE_TRAITS(__header__) ((void)(__header__))
+#endif // VECTOR_COMPACT_HEADER
+
 /**
  * Internal
  * 
- * Reallocates the memory of a vector
+ * Reallocates the memory of a vector through its allocator
+ * realloc is tried first so the allocator can extend (or shrink) the block in place,
+ * for large blocks glibc serves this with mremap, so the pages are remapped instead of copied
  * @param vec          [T*]     - The vector to reallocate
  * @param new_capacity [size_t] - The new capacity of the vector
  * @return             [void*]  - The new data of the vector
- * @throw              [assert] - If the vector is NULL, if malloc fails
+ * @throw              [assert] - If the vector is NULL, if realloc fails
  */
 static void *__vector_realloc(void *vec_ptr, size_t new_capacity) {
     void **temp_ptr = (void **)vec_ptr;
     assertf( temp_ptr != NULL, "ERROR: NULL is not a valid vector\n");
     assertf(*temp_ptr != NULL, "ERROR: Vector is NULL\n");
+    assertf(new_capacity <= __VECTOR_MAX_CAPACITY, "ERROR: Capacity: %zu is too big for the vector header\n", new_capacity);
     __Vector_Header *old_vec = __vector_get_header(vec_ptr);
-    __Vector_Header *new_vec = (__Vector_Header *)malloc(sizeof(__Vector_Header) + new_capacity * old_vec->element_size);
-    assertf(new_vec != NULL, "ERROR: Memory allocation failed\n");
-    memcpy(new_vec, old_vec, sizeof(__Vector_Header) + old_vec->length * old_vec->element_size);
-    new_vec->capacity = new_capacity;    
-    free(old_vec);
+    if (old_vec->flags & __VECTOR_FLAG_INLINE) {
+        // inline storage is never shrunk, outgrowing it moves the vector to its allocator
+        if (new_capacity <= old_vec->capacity) { return old_vec->data; }
+        void *block = __vector_allocator_alloc(__VECTOR_TRAIT(old_vec, allocator), __vector_block_size(old_vec, new_capacity));
+        __Vector_Header *new_vec = __vector_copy_to_block(old_vec, block);
+        __VECTOR_COUNTER_INCREMENT(__vector_resize_count);
+        new_vec->capacity = new_capacity;
+        return new_vec->data;
+    }
+    char *old_block = (char *)__vector_block(old_vec);
+    size_t header_offset = old_vec->header_offset;
+    size_t alignment = __VECTOR_TRAIT(old_vec, alignment);
+    size_t payload_size = __vector_payload_size(old_vec, old_vec->length);
+    const Vector_Allocator *allocator = __VECTOR_TRAIT(old_vec, allocator);
+    char *new_block = (char *)allocator->realloc_fn(allocator->context, old_block, __vector_block_size(old_vec, old_vec->capacity), __vector_block_size(old_vec, new_capacity));
+    assertf(new_block != NULL, "ERROR: Memory allocation failed\n");
+    __VECTOR_COUNTER_INCREMENT(__vector_resize_count);
+    if (new_block == old_block) { __VECTOR_COUNTER_INCREMENT(__vector_inplace_resize_count); }
+    __Vector_Header *new_vec = (__Vector_Header *)(new_block + header_offset);
+    size_t new_header_offset = __vector_header_offset(new_block, alignment);
+    if (new_header_offset != header_offset) {
+        // the block moved to an address with another misalignment, slide the vector to keep the data aligned
+        memmove(new_block + new_header_offset, new_vec, payload_size);
+        new_vec = (__Vector_Header *)(new_block + new_header_offset);
+        new_vec->header_offset = new_header_offset;
+    }
+    new_vec->capacity = new_capacity;
     return new_vec->data;
 }
 
@@ -44,9 +455,13 @@ static void *__vector_realloc(void *vec_ptr, size_t new_capacity) {
      */
     static size_t __vector_calculate_basic_optimal_capacity(void *vec_ptr) {
         __Vector_Header *header = __vector_get_header(vec_ptr);
-        if (header->length < header->initial_capacity) { return header->initial_capacity; }
-        size_t optimal_capacity = header->initial_capacity << (__builtin_clzl(header->initial_capacity) - __builtin_clzl(header->length));
-        return optimal_capacity <= header->length ? optimal_capacity << 1 : optimal_capacity;
+        size_t optimal_capacity = __VECTOR_TRAIT(header, initial_capacity);
+        if (header->length >= __VECTOR_TRAIT(header, initial_capacity)) {
+            optimal_capacity = __VECTOR_TRAIT(header, initial_capacity) << (__builtin_clzl(__VECTOR_TRAIT(header, initial_capacity)) - __builtin_clzl(header->length));
+            if (optimal_capacity <= header->length) { optimal_capacity <<= 1; }
+        }
+        // a vector that still has room is never grown (its capacity may be an exact one from Vector_reserve or Vector_shrink_to_fit)
+        return header->length < header->capacity && optimal_capacity > header->capacity ? header->capacity : optimal_capacity;
     }
 #else // COMPILER_SUPPORTS_BUILTIN_CLZ
     /**
@@ -57,43 +472,189 @@ static void *__vector_realloc(void *vec_ptr, size_t new_capacity) {
      * @return       [size_t] - the optimal capacity for the vector
      */
     static size_t __vector_calculate_basic_optimal_capacity(void *vec_ptr) {
-        void **temp_ptr = (void**)vec_ptr;
         __Vector_Header *header = __vector_get_header(vec_ptr);
-        if (header->length < header->initial_capacity) { return header->initial_capacity; }
-        size_t optimal_capacity = header->initial_capacity;
+        size_t optimal_capacity = __VECTOR_TRAIT(header, initial_capacity);
         while (optimal_capacity <= header->length) { optimal_capacity <<= 1; }
-        return optimal_capacity;
+        // a vector that still has room is never grown (its capacity may be an exact one from Vector_reserve or Vector_shrink_to_fit)
+        return header->length < header->capacity && optimal_capacity > header->capacity ? header->capacity : optimal_capacity;
     }
 #endif // COMPILER_SUPPORTS_BUILTIN_CLZ
 
+size_t Vector_calculate_hysteresis_capacity(void *vec_ptr, double growth_factor, size_t shrink_divisor) {
+    void **temp_ptr = (void **)vec_ptr;
+    assertf( temp_ptr != NULL, "ERROR: NULL is not a valid vector\n");
+    assertf(*temp_ptr != NULL, "ERROR: Vector is NULL\n");
+    assertf(growth_factor > 1.0, "ERROR: Growth factor: %f must be greater than 1\n", growth_factor);
+    assertf(shrink_divisor >= 2, "ERROR: Shrink divisor: %zu must be at least 2\n", shrink_divisor);
+    __Vector_Header *header = __vector_get_header(vec_ptr);
+    size_t capacity = header->capacity;
+    if (header->length >= capacity) {
+        // full: grow by the growth factor until the vector has room for one more element
+        while (capacity <= header->length) {
+            size_t grown_capacity = (size_t)((double)capacity * growth_factor);
+            capacity = grown_capacity > capacity ? grown_capacity : capacity + 1;
+        }
+        return capacity < __VECTOR_TRAIT(header, initial_capacity) ? __VECTOR_TRAIT(header, initial_capacity) : capacity;
+    }
+    // only shrink once the vector is less than 1/shrink_divisor full, and never below the initial capacity
+    // the gap between the two thresholds is what stops a vector that oscillates around a boundary from reallocating on every push/pop
+    while (capacity > __VECTOR_TRAIT(header, initial_capacity) && header->length * shrink_divisor < capacity) {
+        capacity = (size_t)((double)capacity / growth_factor);
+    }
+    if (capacity <= header->length) { capacity = header->length + 1; }
+    return capacity < __VECTOR_TRAIT(header, initial_capacity) ? __VECTOR_TRAIT(header, initial_capacity) : capacity;
+}
+
+size_t Vector_calculate_hysteresis_optimal_capacity(void *vec_ptr) {
+    return Vector_calculate_hysteresis_capacity(vec_ptr, VECTOR_DEFAULT_GROWTH_FACTOR, VECTOR_DEFAULT_SHRINK_DIVISOR);
+}
+
 void __vector_resize_if_needed(void *vec_ptr) {
     void **temp_ptr = (void**)vec_ptr;
     assertf( temp_ptr != NULL, "ERROR: NULL is not a valid vector\n");
     assertf(*temp_ptr != NULL, "ERROR: Vector is NULL\n");
     __Vector_Header *header = __vector_get_header(vec_ptr);
-    size_t optimal_capacity = header->calculate_optimal_capacity_fn == NULL ? __vector_calculate_basic_optimal_capacity(vec_ptr) : header->calculate_optimal_capacity_fn(vec_ptr);
+    size_t optimal_capacity = __VECTOR_TRAIT(header, calculate_optimal_capacity_fn) == NULL ? __vector_calculate_basic_optimal_capacity(vec_ptr) : __VECTOR_TRAIT(header, calculate_optimal_capacity_fn)(vec_ptr);
+    if (optimal_capacity < header->reserved_capacity) { optimal_capacity = header->reserved_capacity; }
     if (optimal_capacity != header->capacity) {
         *temp_ptr = __vector_realloc(vec_ptr, optimal_capacity);
     }
 }
 
-void *__vector_init(size_t element_size) {
-    __Vector_Header *header = (__Vector_Header *)malloc(sizeof(__Vector_Header) + element_size * VECTOR_DEFAULT_INITIAL_CAPACITY);
-    assertf(header != NULL, "ERROR: Memory allocation failed\n");
-    header->element_size = element_size;
+void __vector_grow(void *vec_ptr) {
+    __vector_resize_if_needed(vec_ptr);
+    __Vector_Header *header = __vector_get_header(vec_ptr);
+    assertf(header->capacity > header->length, "ERROR: Optimal capacity: %zu leaves no room for a new element (length: %zu)\n", (size_t)header->capacity, (size_t)header->length);
+}
+
+void __vector_reserve_more(void *vec_ptr, size_t count) {
+    void **temp_ptr = (void **)vec_ptr;
+    assertf( temp_ptr != NULL, "ERROR: NULL is not a valid vector\n");
+    assertf(*temp_ptr != NULL, "ERROR: Vector is NULL\n");
+    __Vector_Header *header = __vector_get_header(vec_ptr);
+    size_t needed_capacity = header->length + count;
+    if (needed_capacity <= header->capacity) { return; }
+    size_t new_capacity = header->capacity > 0 ? header->capacity : 1;
+    while (new_capacity < needed_capacity) { new_capacity <<= 1; }
+    *temp_ptr = __vector_realloc(vec_ptr, new_capacity);
+}
+
+/**
+ * Internal
+ * 
+ * Initializes the header of a new vector
+ * @param header            [__Vector_Header*]  - The header to initialize
+ * @param element_size      [size_t]            - The size of the vector type
+ * @param capacity          [size_t]            - The number of elements the block has room for
+ * @param reserved_capacity [size_t]            - The capacity automatic shrinking will not go below
+ * @param allocator         [Vector_Allocator*] - The allocator of the vector
+ * @param alignment         [size_t]            - The alignment of the data
+ * @param flags             [unsigned int]      - The __VECTOR_FLAG_* bits of the vector
+ * @param header_offset     [size_t]            - The offset of the header in its block
+ */
+static void __vector_init_header(__Vector_Header *header, size_t element_size, size_t capacity, size_t reserved_capacity, const Vector_Allocator *allocator, size_t alignment, unsigned int flags, size_t header_offset) {
+    assertf(capacity <= __VECTOR_MAX_CAPACITY, "ERROR: Capacity: %zu is too big for the vector header\n", capacity);
     header->length = 0;
-    header->capacity = VECTOR_DEFAULT_INITIAL_CAPACITY;
-    header->initial_capacity = VECTOR_DEFAULT_INITIAL_CAPACITY;
-    header->free_fn = NULL;
-    header->calculate_optimal_capacity_fn = NULL;
+    header->capacity = capacity;
+    header->reserved_capacity = reserved_capacity;
+    header->flags = flags;
+    header->header_offset = header_offset;
+    #if VECTOR_COMPACT_HEADER
+        __Vector_Traits traits;
+        traits.element_size = element_size;
+        traits.initial_capacity = VECTOR_DEFAULT_INITIAL_CAPACITY;
+        traits.free_fn = NULL;
+        traits.element_free_fn = NULL;
+        traits.calculate_optimal_capacity_fn = NULL;
+        traits.allocator = allocator;
+        traits.alignment = alignment;
+        header->traits = __vector_intern_traits(&traits);
+    #else // VECTOR_COMPACT_HEADER
+        header->element_size = element_size;
+        header->initial_capacity = VECTOR_DEFAULT_INITIAL_CAPACITY;
+        header->free_fn = NULL;
+        header->element_free_fn = NULL;
+        header->calculate_optimal_capacity_fn = NULL;
+        header->allocator = allocator;
+        header->alignment = alignment;
+    #endif // VECTOR_COMPACT_HEADER
+}
+
+/**
+ * Internal
+ * 
+ * Allocates and initializes the header of a vector
+ * @param element_size      [size_t]            - The size of the vector type
+ * @param capacity          [size_t]            - The number of elements to allocate room for
+ * @param reserved_capacity [size_t]            - The capacity automatic shrinking will not go below
+ * @param allocator         [Vector_Allocator*] - The allocator of the vector, NULL for the default allocator
+ * @param alignment         [size_t]            - The alignment of the data, a power of two at least alignof(max_align_t)
+ * @return                  [__Vector_Header*]  - The header of the new vector
+ * @throw                   [assert]            - If the allocation fails
+ */
+static __Vector_Header *__vector_allocate(size_t element_size, size_t capacity, size_t reserved_capacity, const Vector_Allocator *allocator, size_t alignment) {
+    if (allocator == NULL) { allocator = Vector_get_default_allocator(); }
+    size_t padding = alignment - __VECTOR_MAX_ALIGNMENT;
+    char *block = (char *)__vector_allocator_alloc(allocator, padding + sizeof(__Vector_Header) + element_size * capacity);
+    size_t header_offset = __vector_header_offset(block, alignment);
+    __Vector_Header *header = (__Vector_Header *)(block + header_offset);
+    __vector_init_header(header, element_size, capacity, reserved_capacity, allocator, alignment, 0, header_offset);
+    return header;
+}
+
+void *__vector_init(size_t element_size) {
+    return __vector_allocate(element_size, VECTOR_DEFAULT_INITIAL_CAPACITY, 0, NULL, __VECTOR_MAX_ALIGNMENT)->data;
+}
+
+void *__vector_init_with_capacity(size_t element_size, size_t capacity) {
+    return __vector_allocate(element_size, capacity, capacity, NULL, __VECTOR_MAX_ALIGNMENT)->data;
+}
+
+void *__vector_init_with_allocator(size_t element_size, const Vector_Allocator *allocator) {
+    return __vector_allocate(element_size, VECTOR_DEFAULT_INITIAL_CAPACITY, 0, allocator, __VECTOR_MAX_ALIGNMENT)->data;
+}
+
+void *__vector_init_aligned(size_t element_size, size_t alignment) {
+    assertf(alignment != 0 && (alignment & (alignment - 1)) == 0, "ERROR: Alignment: %zu is not a power of two\n", alignment);
+    if (alignment < __VECTOR_MAX_ALIGNMENT) { alignment = __VECTOR_MAX_ALIGNMENT; }
+    // the header offset is stored in 16 bits
+    assertf(alignment <= UINT16_MAX + 1u, "ERROR: Alignment: %zu is too big for the vector header\n", alignment);
+    return __vector_allocate(element_size, VECTOR_DEFAULT_INITIAL_CAPACITY, 0, NULL, alignment)->data;
+}
+
+void *__vector_init_from(void *src_vec_ptr, size_t element_size, size_t capacity) {
+    void **temp_ptr = (void **)src_vec_ptr;
+    assertf( temp_ptr != NULL, "ERROR: NULL is not a valid vector\n");
+    assertf(*temp_ptr != NULL, "ERROR: Vector is NULL\n");
+    __Vector_Header *src_vec = __vector_get_header(src_vec_ptr);
+    return __vector_allocate(element_size, capacity, 0, __vector_derived_allocator(__VECTOR_TRAIT(src_vec, allocator)), __VECTOR_TRAIT(src_vec, alignment))->data;
+}
+
+void *__vector_init_inline(size_t element_size, void *storage, size_t storage_size) {
+    assertf(storage != NULL, "ERROR: Storage is NULL\n");
+    assertf(storage_size >= sizeof(__Vector_Header) + element_size, "ERROR: Storage of %zu bytes has no room for an element\n", storage_size);
+    __Vector_Header *header = (__Vector_Header *)storage;
+    size_t capacity = (storage_size - sizeof(__Vector_Header)) / element_size;
+    if (capacity > __VECTOR_MAX_CAPACITY) { capacity = __VECTOR_MAX_CAPACITY; }
+    __vector_init_header(header, element_size, capacity, 0, Vector_get_default_allocator(), __VECTOR_MAX_ALIGNMENT, __VECTOR_FLAG_INLINE, 0);
     return header->data;
 }
 
+void *__vector_copy(void *vec_ptr) {
+    void **temp_ptr = (void **)vec_ptr;
+    assertf( temp_ptr != NULL, "ERROR: NULL is not a valid vector\n");
+    assertf(*temp_ptr != NULL, "ERROR: Vector is NULL\n");
+    __Vector_Header *old_vec = __vector_get_header(vec_ptr);
+    void *block = __vector_allocator_alloc(__VECTOR_TRAIT(old_vec, allocator), __vector_block_size(old_vec, old_vec->capacity));
+    __VECTOR_RETAIN_TRAITS(old_vec);
+    return __vector_copy_to_block(old_vec, block)->data;
+}
+
 size_t Vector_get_element_size(void *vec_ptr) {
     void **temp_ptr = (void **)vec_ptr;
     assertf( temp_ptr != NULL, "ERROR: NULL is not a valid vector\n");
     assertf(*temp_ptr != NULL, "ERROR: Vector is NULL\n");
-    return __vector_get_header(vec_ptr)->element_size;
+    return __VECTOR_TRAIT(__vector_get_header(vec_ptr), element_size);
 }
 
 size_t Vector_get_length(void *vec_ptr) {
@@ -114,7 +675,21 @@ size_t Vector_get_initial_capacity(void *vec_ptr) {
     void **temp_ptr = (void **)vec_ptr;
     assertf( temp_ptr != NULL, "ERROR: NULL is not a valid vector\n");
     assertf(*temp_ptr != NULL, "ERROR: Vector is NULL\n");
-    return __vector_get_header(vec_ptr)->initial_capacity;
+    return __VECTOR_TRAIT(__vector_get_header(vec_ptr), initial_capacity);
+}
+
+size_t Vector_get_alignment(void *vec_ptr) {
+    void **temp_ptr = (void **)vec_ptr;
+    assertf( temp_ptr != NULL, "ERROR: NULL is not a valid vector\n");
+    assertf(*temp_ptr != NULL, "ERROR: Vector is NULL\n");
+    return __VECTOR_TRAIT(__vector_get_header(vec_ptr), alignment);
+}
+
+size_t Vector_get_reserved_capacity(void *vec_ptr) {
+    void **temp_ptr = (void **)vec_ptr;
+    assertf( temp_ptr != NULL, "ERROR: NULL is not a valid vector\n");
+    assertf(*temp_ptr != NULL, "ERROR: Vector is NULL\n");
+    return __vector_get_header(vec_ptr)->reserved_capacity;
 }
 
 bool Vector_is_full(void *vec_ptr) {
@@ -130,7 +705,7 @@ bool Vector_is_underfilled(void *vec_ptr) {
     assertf( temp_ptr != NULL, "ERROR: NULL is not a valid vector\n");
     assertf(*temp_ptr != NULL, "ERROR: Vector is NULL\n");
     __Vector_Header *header = __vector_get_header(vec_ptr);
-    return header->capacity > header->initial_capacity && header->length * 2 < header->capacity;
+    return header->capacity > __VECTOR_TRAIT(header, initial_capacity) && header->length * 2 < header->capacity;
 }
 
 bool Vector_is_empty(void *vec_ptr) {
@@ -140,12 +715,140 @@ bool Vector_is_empty(void *vec_ptr) {
     return Vector_get_length(vec_ptr) == 0;
 }
 
+bool Vector_is_inline(void *vec_ptr) {
+    void **temp_ptr = (void **)vec_ptr;
+    assertf( temp_ptr != NULL, "ERROR: NULL is not a valid vector\n");
+    assertf(*temp_ptr != NULL, "ERROR: Vector is NULL\n");
+    return (__vector_get_header(vec_ptr)->flags & __VECTOR_FLAG_INLINE) != 0;
+}
+
 void Vector_set_initial_capacity(void *vec_ptr, size_t initial_capacity) {
     // this function calls __vector_resize_if_needed to immidiately resize the vector if it needs to (the default optimal capacity calculation relies on the initial capacity)
     void **temp_ptr = (void **)vec_ptr;
     assertf( temp_ptr != NULL, "ERROR: NULL is not a valid vector\n");
     assertf(*temp_ptr != NULL, "ERROR: Vector is NULL\n");
-    __vector_get_header(vec_ptr)->initial_capacity = initial_capacity;
+    __Vector_Header *header = __vector_get_header(vec_ptr);
+    __VECTOR_SET_TRAIT(header, initial_capacity, initial_capacity);
+    // the initial capacity is the minimum capacity, the optimal capacity calculation does not grow a vector that still has room
+    if (header->capacity < initial_capacity) { *temp_ptr = __vector_realloc(vec_ptr, initial_capacity); }
+    __vector_resize_if_needed(vec_ptr);
+}
+
+void Vector_reserve(void *vec_ptr, size_t capacity) {
+    void **temp_ptr = (void **)vec_ptr;
+    assertf( temp_ptr != NULL, "ERROR: NULL is not a valid vector\n");
+    assertf(*temp_ptr != NULL, "ERROR: Vector is NULL\n");
+    __Vector_Header *header = __vector_get_header(vec_ptr);
+    header->reserved_capacity = capacity;
+    if (header->capacity < capacity) { *temp_ptr = __vector_realloc(vec_ptr, capacity); }
+}
+
+void Vector_shrink_to_fit(void *vec_ptr) {
+    void **temp_ptr = (void **)vec_ptr;
+    assertf( temp_ptr != NULL, "ERROR: NULL is not a valid vector\n");
+    assertf(*temp_ptr != NULL, "ERROR: Vector is NULL\n");
+    __Vector_Header *header = __vector_get_header(vec_ptr);
+    header->reserved_capacity = 0;
+    if (header->capacity != header->length) { *temp_ptr = __vector_realloc(vec_ptr, header->length); }
+}
+
+void Vector_extend_from_array(void *vec_ptr, const void *array, size_t count) {
+    void **temp_ptr = (void **)vec_ptr;
+    assertf( temp_ptr != NULL, "ERROR: NULL is not a valid vector\n");
+    assertf(*temp_ptr != NULL, "ERROR: Vector is NULL\n");
+    assertf(array != NULL || count == 0, "ERROR: Array is NULL\n");
+    if (count == 0) { return; }
+    __Vector_Header *header = __vector_get_header(vec_ptr);
+    size_t element_size = __VECTOR_TRAIT(header, element_size);
+    // the array may be (a part of) the vector itself, it has to be found again after the vector moves
+    const char *data = (const char *)*temp_ptr;
+    bool is_aliased = (const char *)array >= data && (const char *)array < data + header->capacity * element_size;
+    size_t alias_offset = is_aliased ? (size_t)((const char *)array - data) : 0;
+    __vector_reserve_more(vec_ptr, count);
+    header = __vector_get_header(vec_ptr);
+    if (is_aliased) { array = (const char *)*temp_ptr + alias_offset; }
+    memcpy((char *)*temp_ptr + header->length * element_size, array, count * element_size);
+    header->length += count;
+}
+
+void Vector_insert_range(void *vec_ptr, size_t index, const void *array, size_t count) {
+    void **temp_ptr = (void **)vec_ptr;
+    assertf( temp_ptr != NULL, "ERROR: NULL is not a valid vector\n");
+    assertf(*temp_ptr != NULL, "ERROR: Vector is NULL\n");
+    __Vector_Header *header = __vector_get_header(vec_ptr);
+    assertf(index <= header->length, "ERROR: Index: %zu out of bounds [0, %zu]\n", index, (size_t)header->length);
+    assertf(array != NULL || count == 0, "ERROR: Array is NULL\n");
+    if (count == 0) { return; }
+    size_t element_size = __VECTOR_TRAIT(header, element_size);
+    const char *data = (const char *)*temp_ptr;
+    bool is_aliased = (const char *)array >= data && (const char *)array < data + header->capacity * element_size;
+    size_t alias_index = is_aliased ? (size_t)((const char *)array - data) / element_size : 0;
+    __vector_reserve_more(vec_ptr, count);
+    header = __vector_get_header(vec_ptr);
+    char *vec = (char *)*temp_ptr;
+    memmove(vec + (index + count) * element_size, vec + index * element_size, (header->length - index) * element_size);
+    if (is_aliased) {
+        // the source elements before the insertion point did not move, the ones after it moved `count` places to the right
+        size_t unmoved = alias_index < index ? index - alias_index : 0;
+        if (unmoved > count) { unmoved = count; }
+        memcpy(vec + index * element_size, vec + alias_index * element_size, unmoved * element_size);
+        memcpy(vec + (index + unmoved) * element_size, vec + (alias_index + unmoved + count) * element_size, (count - unmoved) * element_size);
+    } else {
+        memcpy(vec + index * element_size, array, count * element_size);
+    }
+    header->length += count;
+}
+
+void Vector_remove_range(void *vec_ptr, size_t index, size_t count, void *out) {
+    void **temp_ptr = (void **)vec_ptr;
+    assertf( temp_ptr != NULL, "ERROR: NULL is not a valid vector\n");
+    assertf(*temp_ptr != NULL, "ERROR: Vector is NULL\n");
+    __Vector_Header *header = __vector_get_header(vec_ptr);
+    assertf(index <= header->length && count <= header->length - index, "ERROR: Range: [%zu, %zu) out of bounds [0, %zu)\n", index, index + count, (size_t)header->length);
+    if (count == 0) { return; }
+    size_t element_size = __VECTOR_TRAIT(header, element_size);
+    char *vec = (char *)*temp_ptr;
+    if (out != NULL) { memcpy(out, vec + index * element_size, count * element_size); }
+    else { __vector_free_elements(vec_ptr, index, count); }
+    memmove(vec + index * element_size, vec + (index + count) * element_size, (header->length - index - count) * element_size);
+    header->length -= count;
+    __vector_resize_if_needed(vec_ptr);
+}
+
+/**
+ * Internal
+ * 
+ * qsort comparator ordering indices from the largest to the smallest
+ * @param a [size_t*] - The first index
+ * @param b [size_t*] - The second index
+ * @return  [int]     - Negative if a goes first, positive if b goes first, 0 if they are equal
+ */
+static int __vector_compare_indices_descending(const void *a, const void *b) {
+    size_t x = *(const size_t *)a, y = *(const size_t *)b;
+    return (x < y) - (x > y);
+}
+
+void Vector_swap_remove_indices(void *vec_ptr, size_t *indices, size_t count) {
+    void **temp_ptr = (void **)vec_ptr;
+    assertf( temp_ptr != NULL, "ERROR: NULL is not a valid vector\n");
+    assertf(*temp_ptr != NULL, "ERROR: Vector is NULL\n");
+    if (count == 0) { return; }
+    assertf(indices != NULL, "ERROR: Indices are NULL\n");
+    __Vector_Header *header = __vector_get_header(vec_ptr);
+    qsort(indices, count, sizeof(size_t), __vector_compare_indices_descending);
+    assertf(indices[0] < header->length, "ERROR: Index: %zu out of bounds [0, %zu)\n", indices[0], (size_t)header->length);
+    size_t element_size = __VECTOR_TRAIT(header, element_size);
+    Vector_element_free_fn element_free_fn = __VECTOR_TRAIT(header, element_free_fn);
+    char *vec = (char *)*temp_ptr;
+    for (size_t i = 0; i < count; i++) {
+        // going from the largest index down, the last element is never one that is still to be removed
+        assertf(i == 0 || indices[i] != indices[i - 1], "ERROR: Index: %zu appears twice\n", indices[i]);
+        char *element = vec + indices[i] * element_size;
+        if (element_free_fn != NULL) { element_free_fn(element); }
+        size_t last = header->length - 1;
+        if (indices[i] != last) { memcpy(element, vec + last * element_size, element_size); }
+        header->length--;
+    }
     __vector_resize_if_needed(vec_ptr);
 }
 
@@ -153,12 +856,1974 @@ void Vector_set_free_fn(void *vec_ptr, Vector_free_fn free_fn) {
     void **temp_ptr = (void **)vec_ptr;
     assertf( temp_ptr != NULL, "ERROR: NULL is not a valid vector\n");
     assertf(*temp_ptr != NULL, "ERROR: Vector is NULL\n");
-    __vector_get_header(vec_ptr)->free_fn = free_fn;
+    __VECTOR_SET_TRAIT(__vector_get_header(vec_ptr), free_fn, free_fn);
+}
+
+void Vector_set_element_free_fn(void *vec_ptr, Vector_element_free_fn element_free_fn) {
+    void **temp_ptr = (void **)vec_ptr;
+    assertf( temp_ptr != NULL, "ERROR: NULL is not a valid vector\n");
+    assertf(*temp_ptr != NULL, "ERROR: Vector is NULL\n");
+    __VECTOR_SET_TRAIT(__vector_get_header(vec_ptr), element_free_fn, element_free_fn);
+}
+
+void __vector_free_elements(void *vec_ptr, size_t index, size_t count) {
+    __Vector_Header *header = __vector_get_header(vec_ptr);
+    Vector_element_free_fn element_free_fn = __VECTOR_TRAIT(header, element_free_fn);
+    if (element_free_fn == NULL) { return; }
+    size_t element_size = __VECTOR_TRAIT(header, element_size);
+    char *element = (char *)*(void **)vec_ptr + index * element_size;
+    for (size_t i = 0; i < count; i++, element += element_size) { element_free_fn(element); }
 }
 
 void Vector_set_calculate_optimal_capacity_fn(void *vec_ptr, Vector_calculate_optimal_capacity_fn calculate_optimal_capacity_fn) {
     void **temp_ptr = (void **)vec_ptr;
     assertf( temp_ptr != NULL, "ERROR: NULL is not a valid vector\n");
     assertf(*temp_ptr != NULL, "ERROR: Vector is NULL\n");
-    __vector_get_header(vec_ptr)->calculate_optimal_capacity_fn = calculate_optimal_capacity_fn;
+    __VECTOR_SET_TRAIT(__vector_get_header(vec_ptr), calculate_optimal_capacity_fn, calculate_optimal_capacity_fn);
+}
+
+size_t Vector_get_resize_count(void) {
+    return __VECTOR_COUNTER_LOAD(__vector_resize_count);
+}
+
+size_t Vector_get_inplace_resize_count(void) {
+    return __VECTOR_COUNTER_LOAD(__vector_inplace_resize_count);
+}
+
+void Vector_set_default_allocator(const Vector_Allocator *allocator) {
+    __vector_default_allocator = allocator == NULL ? &Vector_malloc_allocator : allocator;
+}
+
+const Vector_Allocator *Vector_get_default_allocator(void) {
+    return __vector_scope_allocator != NULL ? __vector_scope_allocator : __vector_default_allocator;
+}
+
+const Vector_Allocator *Vector_get_allocator(void *vec_ptr) {
+    void **temp_ptr = (void **)vec_ptr;
+    assertf( temp_ptr != NULL, "ERROR: NULL is not a valid vector\n");
+    assertf(*temp_ptr != NULL, "ERROR: Vector is NULL\n");
+    return __VECTOR_TRAIT(__vector_get_header(vec_ptr), allocator);
+}
+
+void Vector_set_allocator(void *vec_ptr, const Vector_Allocator *allocator) {
+    void **temp_ptr = (void **)vec_ptr;
+    assertf( temp_ptr != NULL, "ERROR: NULL is not a valid vector\n");
+    assertf(*temp_ptr != NULL, "ERROR: Vector is NULL\n");
+    if (allocator == NULL) { allocator = Vector_get_default_allocator(); }
+    __Vector_Header *old_vec = __vector_get_header(vec_ptr);
+    if (__VECTOR_TRAIT(old_vec, allocator) == allocator) { return; }
+    if (old_vec->flags & __VECTOR_FLAG_INLINE) {
+        // the vector stays in its storage, the new allocator is the one it will move to
+        __VECTOR_SET_TRAIT(old_vec, allocator, allocator);
+        return;
+    }
+    const Vector_Allocator *old_allocator = __VECTOR_TRAIT(old_vec, allocator);
+    size_t block_size = __vector_block_size(old_vec, old_vec->capacity);
+    void *block = __vector_allocator_alloc(allocator, block_size);
+    __Vector_Header *new_vec = __vector_copy_to_block(old_vec, block);
+    // the copy took over the reference of the old header to its traits, setting the allocator may release them
+    __VECTOR_SET_TRAIT(new_vec, allocator, allocator);
+    __vector_allocator_free(old_allocator, __vector_block(old_vec), block_size);
+    *temp_ptr = new_vec->data;
+}
+
+void Vector_deallocate(void *vec_ptr) {
+    void **temp_ptr = (void **)vec_ptr;
+    assertf( temp_ptr != NULL, "ERROR: NULL is not a valid vector\n");
+    assertf(*temp_ptr != NULL, "ERROR: Vector is NULL\n");
+    __Vector_Header *header = __vector_get_header(vec_ptr);
+    const Vector_Allocator *allocator = __VECTOR_TRAIT(header, allocator);
+    size_t block_size = __vector_block_size(header, header->capacity);
+    __VECTOR_RELEASE_TRAITS(header);
+    if (!(header->flags & __VECTOR_FLAG_INLINE)) { __vector_allocator_free(allocator, __vector_block(header), block_size); }
+    *temp_ptr = NULL;
+}
+
+typedef struct __Vector_Arena_Chunk {
+    struct __Vector_Arena_Chunk *next; // the previous (older) chunk
+    size_t capacity; // the number of bytes after the chunk header
+    size_t used; // the number of bytes handed out, the next allocation starts at data + used
+    __VECTOR_MAX_ALIGNED char data[];
+} __Vector_Arena_Chunk;
+
+/**
+ * Internal
+ * 
+ * Rounds a size up so every allocation of an arena stays aligned for any fundamental type
+ * @param size [size_t] - The size to round
+ * @return     [size_t] - The rounded size
+ */
+static size_t __vector_arena_round(size_t size) {
+    return (size + __VECTOR_MAX_ALIGNMENT - 1) & ~(__VECTOR_MAX_ALIGNMENT - 1);
+}
+
+/**
+ * Internal
+ * 
+ * Bumps `size` bytes from the current chunk of the arena, starting a new chunk if it does not fit
+ * @param context [Vector_Arena*] - The arena
+ * @param size    [size_t]        - The number of bytes to allocate
+ * @return        [void*]         - The allocated memory, NULL if malloc fails
+ */
+static void *__vector_arena_alloc(void *context, size_t size) {
+    Vector_Arena *arena = (Vector_Arena *)context;
+    size = __vector_arena_round(size);
+    __Vector_Arena_Chunk *chunk = arena->chunk;
+    if (chunk == NULL || chunk->capacity - chunk->used < size) {
+        size_t capacity = size > arena->chunk_size ? size : arena->chunk_size;
+        chunk = (__Vector_Arena_Chunk *)malloc(sizeof(__Vector_Arena_Chunk) + capacity);
+        if (chunk == NULL) { return NULL; }
+        chunk->next = arena->chunk;
+        chunk->capacity = capacity;
+        chunk->used = 0;
+        arena->chunk = chunk;
+    }
+    void *ptr = chunk->data + chunk->used;
+    chunk->used += size;
+    return ptr;
+}
+
+/**
+ * Internal
+ * 
+ * Resizes a block of the arena
+ * The last allocation of the current chunk is resized in place when it fits (when it is alone in its chunk, the chunk itself is realloc-ed),
+ * any other block is kept in place when it shrinks and copied to a new block (abandoning the old one) when it grows
+ * @param context  [Vector_Arena*] - The arena
+ * @param ptr      [void*]         - The block to resize
+ * @param old_size [size_t]        - The size of the block
+ * @param new_size [size_t]        - The new size of the block
+ * @return         [void*]         - The resized block, NULL if malloc fails
+ */
+static void *__vector_arena_realloc(void *context, void *ptr, size_t old_size, size_t new_size) {
+    Vector_Arena *arena = (Vector_Arena *)context;
+    __Vector_Arena_Chunk *chunk = arena->chunk;
+    old_size = __vector_arena_round(old_size);
+    new_size = __vector_arena_round(new_size);
+    bool is_last = chunk != NULL && (char *)ptr + old_size == chunk->data + chunk->used;
+    if (is_last && (char *)ptr + new_size <= chunk->data + chunk->capacity) {
+        chunk->used = (size_t)((char *)ptr - chunk->data) + new_size;
+        return ptr;
+    }
+    if (is_last && (char *)ptr == chunk->data) {
+        __Vector_Arena_Chunk *new_chunk = (__Vector_Arena_Chunk *)realloc(chunk, sizeof(__Vector_Arena_Chunk) + new_size);
+        if (new_chunk == NULL) { return NULL; }
+        new_chunk->capacity = new_size;
+        new_chunk->used = new_size;
+        arena->chunk = new_chunk;
+        return new_chunk->data;
+    }
+    if (new_size <= old_size) { return ptr; }
+    void *new_ptr = __vector_arena_alloc(context, new_size);
+    if (new_ptr == NULL) { return NULL; }
+    memcpy(new_ptr, ptr, old_size);
+    // the old block was the top of a chunk that is not current anymore, or is in the middle of a chunk: it is abandoned
+    return new_ptr;
+}
+
+/**
+ * Internal
+ * 
+ * Gives a block back to the arena if it is the last allocation of the current chunk, does nothing otherwise
+ * @param context [Vector_Arena*] - The arena
+ * @param ptr     [void*]         - The block to free
+ * @param size    [size_t]        - The size of the block
+ */
+static void __vector_arena_free(void *context, void *ptr, size_t size) {
+    Vector_Arena *arena = (Vector_Arena *)context;
+    __Vector_Arena_Chunk *chunk = arena->chunk;
+    if (chunk != NULL && (char *)ptr + __vector_arena_round(size) == chunk->data + chunk->used) {
+        chunk->used = (size_t)((char *)ptr - chunk->data);
+    }
+}
+
+void Vector_arena_init(Vector_Arena *arena, size_t chunk_size) {
+    assertf(arena != NULL, "ERROR: Arena is NULL\n");
+    arena->allocator.alloc_fn = __vector_arena_alloc;
+    arena->allocator.realloc_fn = __vector_arena_realloc;
+    arena->allocator.free_fn = __vector_arena_free;
+    arena->allocator.context = arena;
+    arena->chunk = NULL;
+    arena->chunk_size = chunk_size == 0 ? VECTOR_ARENA_DEFAULT_CHUNK_SIZE : chunk_size;
+}
+
+void Vector_arena_destroy(Vector_Arena *arena) {
+    assertf(arena != NULL, "ERROR: Arena is NULL\n");
+    while (arena->chunk != NULL) {
+        __Vector_Arena_Chunk *next = arena->chunk->next;
+        free(arena->chunk);
+        arena->chunk = next;
+    }
+}
+
+void Vector_arena_reset(Vector_Arena *arena) {
+    assertf(arena != NULL, "ERROR: Arena is NULL\n");
+    if (arena->chunk == NULL) { return; }
+    while (arena->chunk->next != NULL) {
+        __Vector_Arena_Chunk *next = arena->chunk->next;
+        free(arena->chunk);
+        arena->chunk = next;
+    }
+    arena->chunk->used = 0;
+}
+
+const Vector_Allocator *Vector_arena_get_allocator(Vector_Arena *arena) {
+    assertf(arena != NULL, "ERROR: Arena is NULL\n");
+    return &arena->allocator;
+}
+
+void Vector_arena_begin_scope(Vector_Arena *arena) {
+    assertf(arena != NULL, "ERROR: Arena is NULL\n");
+    assertf(__vector_scope_depth < __VECTOR_ARENA_MAX_SCOPE_DEPTH, "ERROR: More than %d nested arena scopes\n", __VECTOR_ARENA_MAX_SCOPE_DEPTH);
+    __vector_scope_stack[__vector_scope_depth++] = __vector_scope_allocator;
+    __vector_scope_allocator = &arena->allocator;
+}
+
+void Vector_arena_end_scope(Vector_Arena *arena) {
+    assertf(arena != NULL, "ERROR: Arena is NULL\n");
+    assertf(__vector_scope_allocator == &arena->allocator, "ERROR: The arena is not the current scope\n");
+    __vector_scope_allocator = __vector_scope_stack[--__vector_scope_depth];
+}
+
+#define __VECTOR_POOL_CLASS_COUNT (sizeof(size_t) * 8)
+
+// the blocks of a slab start after its header, at the first multiple of the smallest block size
+#define __VECTOR_POOL_SLAB_HEADER_SIZE ((sizeof(__Vector_Pool_Slab) + VECTOR_POOL_MIN_BLOCK_SIZE - 1) / VECTOR_POOL_MIN_BLOCK_SIZE * VECTOR_POOL_MIN_BLOCK_SIZE)
+
+#if LANGUAGE_CPP
+    static_assert(VECTOR_POOL_SLAB_SIZE % VECTOR_POOL_MAX_BLOCK_SIZE == 0, "VECTOR_POOL_MAX_BLOCK_SIZE must divide VECTOR_POOL_SLAB_SIZE");
+#else // LANGUAGE_CPP
+    _Static_assert(VECTOR_POOL_SLAB_SIZE % VECTOR_POOL_MAX_BLOCK_SIZE == 0, "VECTOR_POOL_MAX_BLOCK_SIZE must divide VECTOR_POOL_SLAB_SIZE");
+#endif // LANGUAGE_CPP
+
+struct __Vector_Pool_Heap;
+
+// the start of a slab, slabs are aligned to VECTOR_POOL_SLAB_SIZE so a block finds its slab by masking its address
+typedef struct __Vector_Pool_Slab {
+    struct __Vector_Pool_Heap *heap; // the heap of the thread that allocated the slab
+    struct __Vector_Pool_Slab *next; // the other slabs of the heap
+    size_t class_index;
+    size_t live_count; // the blocks handed out and not given back to the heap yet
+} __Vector_Pool_Slab;
+
+typedef struct __Vector_Pool_Class {
+    void *free_list; // the freed blocks of the class, each one starts with a pointer to the next
+    char *bump; // the next never used block of the current slab
+    char *end; // the end of the current slab
+} __Vector_Pool_Class;
+
+// the pool of a thread: only its thread touches the classes and the slabs, other threads push the blocks they free to the remote free list,
+// once the thread exits (dead) the remaining slabs are freed by the threads freeing their last blocks
+typedef struct __Vector_Pool_Heap {
+    __Vector_Pool_Class classes[__VECTOR_POOL_CLASS_COUNT];
+    __Vector_Pool_Slab *slabs;
+    __Vector_Spin_Lock lock; // guards remote_free and dead, and the slabs once dead
+    __VECTOR_ATOMIC(void *) remote_free; // the blocks freed by other threads, taken back by the next allocation missing its free list
+    bool dead;
+} __Vector_Pool_Heap;
+
+static __VECTOR_THREAD_LOCAL __Vector_Pool_Heap *__vector_pool_heap = NULL;
+static __VECTOR_ATOMIC(size_t) __vector_pool_malloc_count;
+
+#if COMPILER_SUPPORTS_BUILTIN_CLZ
+    /**
+     * Internal
+     * 
+     * Returns the size class of a block
+     * @param size [size_t] - The size of the block, at most VECTOR_POOL_MAX_BLOCK_SIZE
+     * @return     [size_t] - The index of the class, the block size of class i is VECTOR_POOL_MIN_BLOCK_SIZE << i
+     */
+    static size_t __vector_pool_class(size_t size) {
+        if (size <= VECTOR_POOL_MIN_BLOCK_SIZE) { return 0; }
+        return (size_t)(__builtin_clzl(VECTOR_POOL_MIN_BLOCK_SIZE - 1) - __builtin_clzl(size - 1));
+    }
+#else // COMPILER_SUPPORTS_BUILTIN_CLZ
+    /**
+     * Internal
+     * 
+     * Returns the size class of a block
+     * @param size [size_t] - The size of the block, at most VECTOR_POOL_MAX_BLOCK_SIZE
+     * @return     [size_t] - The index of the class, the block size of class i is VECTOR_POOL_MIN_BLOCK_SIZE << i
+     */
+    static size_t __vector_pool_class(size_t size) {
+        size_t class_index = 0;
+        while (((size_t)VECTOR_POOL_MIN_BLOCK_SIZE << class_index) < size) { class_index++; }
+        return class_index;
+    }
+#endif // COMPILER_SUPPORTS_BUILTIN_CLZ
+
+/**
+ * Internal
+ * 
+ * Returns the slab of a block
+ * @param block [void*]               - The block
+ * @return      [__Vector_Pool_Slab*] - The slab holding it
+ */
+static __Vector_Pool_Slab *__vector_pool_slab_of(void *block) {
+    return (__Vector_Pool_Slab *)((uintptr_t)block & ~((uintptr_t)VECTOR_POOL_SLAB_SIZE - 1));
+}
+
+/**
+ * Internal
+ * 
+ * Allocates a slab aligned to its size
+ * @return [void*] - The slab, NULL if it cannot be allocated
+ */
+static void *__vector_pool_slab_alloc(void) {
+    #if defined(_WIN32)
+        return _aligned_malloc(VECTOR_POOL_SLAB_SIZE, VECTOR_POOL_SLAB_SIZE);
+    #else
+        void *slab = NULL;
+        return posix_memalign(&slab, VECTOR_POOL_SLAB_SIZE, VECTOR_POOL_SLAB_SIZE) == 0 ? slab : NULL;
+    #endif // defined(_WIN32)
+}
+
+/**
+ * Internal
+ * 
+ * Frees a slab allocated by __vector_pool_slab_alloc
+ * @param slab [__Vector_Pool_Slab*] - The slab
+ */
+static void __vector_pool_slab_free(__Vector_Pool_Slab *slab) {
+    #if defined(_WIN32)
+        _aligned_free(slab);
+    #else
+        free(slab);
+    #endif // defined(_WIN32)
+}
+
+/**
+ * Internal
+ * 
+ * Unlinks a slab from its heap and frees it
+ * @param heap [__Vector_Pool_Heap*] - The heap
+ * @param slab [__Vector_Pool_Slab*] - The slab, without live blocks
+ */
+static void __vector_pool_heap_free_slab(__Vector_Pool_Heap *heap, __Vector_Pool_Slab *slab) {
+    __Vector_Pool_Slab **link = &heap->slabs;
+    while (*link != slab) { link = &(*link)->next; }
+    *link = slab->next;
+    __Vector_Pool_Class *pool_class = &heap->classes[slab->class_index];
+    if (pool_class->bump != NULL && __vector_pool_slab_of(pool_class->bump) == slab) { pool_class->bump = pool_class->end = NULL; }
+    __vector_pool_slab_free(slab);
+}
+
+/**
+ * Internal
+ * 
+ * Takes back the blocks other threads freed to a heap, onto the free lists of their classes
+ * @param heap [__Vector_Pool_Heap*] - The heap of the calling thread
+ */
+static void __vector_pool_heap_drain(__Vector_Pool_Heap *heap) {
+    if (__VECTOR_LOAD_ACQUIRE(heap->remote_free) == NULL) { return; }
+    __VECTOR_SPIN_LOCK(heap->lock);
+    void *block = heap->remote_free;
+    heap->remote_free = NULL;
+    __VECTOR_SPIN_UNLOCK(heap->lock);
+    while (block != NULL) {
+        void *next = *(void **)block;
+        __Vector_Pool_Slab *slab = __vector_pool_slab_of(block);
+        __Vector_Pool_Class *pool_class = &heap->classes[slab->class_index];
+        slab->live_count--;
+        *(void **)block = pool_class->free_list;
+        pool_class->free_list = block;
+        block = next;
+    }
+}
+
+/**
+ * Internal
+ * 
+ * Gives the slabs of a heap without live blocks back to the system, their blocks are taken off the free lists
+ * @param heap [__Vector_Pool_Heap*] - The heap of the calling thread
+ */
+static void __vector_pool_heap_trim(__Vector_Pool_Heap *heap) {
+    __vector_pool_heap_drain(heap);
+    for (size_t i = 0; i < __VECTOR_POOL_CLASS_COUNT; i++) {
+        void **link = &heap->classes[i].free_list;
+        while (*link != NULL) {
+            if (__vector_pool_slab_of(*link)->live_count == 0) { *link = *(void **)*link; }
+            else { link = (void **)*link; }
+        }
+    }
+    __Vector_Pool_Slab *slab = heap->slabs;
+    while (slab != NULL) {
+        __Vector_Pool_Slab *next = slab->next;
+        if (slab->live_count == 0) { __vector_pool_heap_free_slab(heap, slab); }
+        slab = next;
+    }
+}
+
+#if VECTOR_THREADS
+    static pthread_key_t __vector_pool_key;
+    static pthread_once_t __vector_pool_key_once = PTHREAD_ONCE_INIT;
+
+    /**
+     * Internal
+     * 
+     * Runs when a thread having a pool exits: the slabs without live blocks are freed, the others when their last block is freed
+     * @param arg [__Vector_Pool_Heap*] - The heap of the thread
+     */
+    static void __vector_pool_thread_exit(void *arg) {
+        __Vector_Pool_Heap *heap = (__Vector_Pool_Heap *)arg;
+        __vector_pool_heap = NULL;
+        __vector_pool_heap_trim(heap);
+        __VECTOR_SPIN_LOCK(heap->lock);
+        heap->dead = true;
+        // a block freed by another thread between the trim and the lock
+        void *block = heap->remote_free;
+        heap->remote_free = NULL;
+        while (block != NULL) {
+            void *next = *(void **)block;
+            __Vector_Pool_Slab *slab = __vector_pool_slab_of(block);
+            if (--slab->live_count == 0) { __vector_pool_heap_free_slab(heap, slab); }
+            block = next;
+        }
+        bool empty = heap->slabs == NULL;
+        __VECTOR_SPIN_UNLOCK(heap->lock);
+        if (empty) { free(heap); }
+    }
+
+    /**
+     * Internal
+     * 
+     * Creates the key whose destructor releases the pool of an exiting thread, called once
+     */
+    static void __vector_pool_create_key(void) {
+        pthread_key_create(&__vector_pool_key, __vector_pool_thread_exit);
+    }
+#endif // VECTOR_THREADS
+
+/**
+ * Internal
+ * 
+ * Returns the heap of the calling thread, creating it on the first call
+ * @return [__Vector_Pool_Heap*] - The heap, NULL if it cannot be allocated
+ */
+static __Vector_Pool_Heap *__vector_pool_get_heap(void) {
+    if (__vector_pool_heap != NULL) { return __vector_pool_heap; }
+    __Vector_Pool_Heap *heap = (__Vector_Pool_Heap *)calloc(1, sizeof(__Vector_Pool_Heap));
+    if (heap == NULL) { return NULL; }
+    #if VECTOR_THREADS
+        pthread_once(&__vector_pool_key_once, __vector_pool_create_key);
+        pthread_setspecific(__vector_pool_key, heap);
+    #endif // VECTOR_THREADS
+    __vector_pool_heap = heap;
+    return heap;
+}
+
+static void *__vector_pool_alloc(void *context, size_t size) {
+    (void)context;
+    if (size > VECTOR_POOL_MAX_BLOCK_SIZE) {
+        __VECTOR_COUNTER_INCREMENT(__vector_pool_malloc_count);
+        return malloc(size);
+    }
+    __Vector_Pool_Heap *heap = __vector_pool_get_heap();
+    if (heap == NULL) { return NULL; }
+    size_t class_index = __vector_pool_class(size);
+    size_t block_size = (size_t)VECTOR_POOL_MIN_BLOCK_SIZE << class_index;
+    __Vector_Pool_Class *pool_class = &heap->classes[class_index];
+    if (pool_class->free_list == NULL) { __vector_pool_heap_drain(heap); }
+    if (pool_class->free_list != NULL) {
+        void *block = pool_class->free_list;
+        pool_class->free_list = *(void **)block;
+        __vector_pool_slab_of(block)->live_count++;
+        return block;
+    }
+    if ((size_t)(pool_class->end - pool_class->bump) < block_size) {
+        __Vector_Pool_Slab *slab = (__Vector_Pool_Slab *)__vector_pool_slab_alloc();
+        if (slab == NULL) { return NULL; }
+        __VECTOR_COUNTER_INCREMENT(__vector_pool_malloc_count);
+        slab->heap = heap;
+        slab->class_index = class_index;
+        slab->live_count = 0;
+        slab->next = heap->slabs;
+        heap->slabs = slab;
+        pool_class->bump = (char *)slab + __VECTOR_POOL_SLAB_HEADER_SIZE;
+        pool_class->end = (char *)slab + VECTOR_POOL_SLAB_SIZE;
+    }
+    void *block = pool_class->bump;
+    pool_class->bump += block_size;
+    __vector_pool_slab_of(block)->live_count++;
+    return block;
+}
+
+static void __vector_pool_free(void *context, void *ptr, size_t size) {
+    (void)context;
+    if (size > VECTOR_POOL_MAX_BLOCK_SIZE) {
+        free(ptr);
+        return;
+    }
+    __Vector_Pool_Slab *slab = __vector_pool_slab_of(ptr);
+    __Vector_Pool_Heap *heap = slab->heap;
+    if (heap == __vector_pool_heap) {
+        __Vector_Pool_Class *pool_class = &heap->classes[slab->class_index];
+        *(void **)ptr = pool_class->free_list;
+        pool_class->free_list = ptr;
+        slab->live_count--;
+        return;
+    }
+    // a block of another thread goes back to its heap, or straight to its slab if that thread exited
+    __VECTOR_SPIN_LOCK(heap->lock);
+    if (!heap->dead) {
+        *(void **)ptr = heap->remote_free;
+        __VECTOR_STORE_RELEASE(heap->remote_free, ptr);
+        __VECTOR_SPIN_UNLOCK(heap->lock);
+        return;
+    }
+    if (--slab->live_count == 0) { __vector_pool_heap_free_slab(heap, slab); }
+    bool empty = heap->slabs == NULL;
+    __VECTOR_SPIN_UNLOCK(heap->lock);
+    if (empty) { free(heap); }
+}
+
+static void *__vector_pool_realloc(void *context, void *ptr, size_t old_size, size_t new_size) {
+    if (old_size > VECTOR_POOL_MAX_BLOCK_SIZE && new_size > VECTOR_POOL_MAX_BLOCK_SIZE) {
+        __VECTOR_COUNTER_INCREMENT(__vector_pool_malloc_count);
+        return realloc(ptr, new_size);
+    }
+    if (old_size <= VECTOR_POOL_MAX_BLOCK_SIZE && new_size <= VECTOR_POOL_MAX_BLOCK_SIZE && __vector_pool_class(old_size) == __vector_pool_class(new_size)) {
+        return ptr;
+    }
+    void *new_ptr = __vector_pool_alloc(context, new_size);
+    if (new_ptr == NULL) { return NULL; }
+    memcpy(new_ptr, ptr, old_size < new_size ? old_size : new_size);
+    __vector_pool_free(context, ptr, old_size);
+    return new_ptr;
+}
+
+const Vector_Allocator Vector_pool_allocator = { __vector_pool_alloc, __vector_pool_realloc, __vector_pool_free, NULL };
+
+size_t Vector_pool_get_malloc_count(void) {
+    return __VECTOR_COUNTER_LOAD(__vector_pool_malloc_count);
+}
+
+void Vector_pool_release(void) {
+    if (__vector_pool_heap != NULL) { __vector_pool_heap_trim(__vector_pool_heap); }
+}
+
+#if defined(__linux__)
+    // the huge page size, the smallest mapping and the rounding of the mappings bigger than the ceiling
+    #define __VECTOR_MMAP_ROUNDING ((size_t)2 << 20)
+
+    /**
+     * Internal
+     * 
+     * Returns the length of the mapping holding a block: the power of two above its size (at least a huge page) up to VECTOR_MMAP_MAX_RESERVE_SIZE,
+     * so a growing block is remapped once per doubling, and past the ceiling the size rounded up to a huge page
+     * @param size [size_t] - The size of the block
+     * @return     [size_t] - The length of its mapping
+     */
+    static size_t __vector_mmap_length(size_t size) {
+        size_t length = (size + __VECTOR_MMAP_ROUNDING - 1) & ~(__VECTOR_MMAP_ROUNDING - 1);
+        if (length > VECTOR_MMAP_MAX_RESERVE_SIZE) { return length; }
+        size_t reserve = __VECTOR_MMAP_ROUNDING;
+        while (reserve < length) { reserve <<= 1; }
+        return reserve < VECTOR_MMAP_MAX_RESERVE_SIZE ? reserve : VECTOR_MMAP_MAX_RESERVE_SIZE;
+    }
+
+    static void *__vector_mmap_alloc(void *context, size_t size) {
+        (void)context;
+        size_t length = __vector_mmap_length(size);
+        void *ptr = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (ptr == MAP_FAILED) { return NULL; }
+        #if defined(MADV_HUGEPAGE)
+            madvise(ptr, length, MADV_HUGEPAGE); // only a hint, the mapping works without huge pages
+        #endif // defined(MADV_HUGEPAGE)
+        return ptr;
+    }
+
+    static void *__vector_mmap_realloc(void *context, void *ptr, size_t old_size, size_t new_size) {
+        (void)context;
+        size_t old_length = __vector_mmap_length(old_size);
+        size_t new_length = __vector_mmap_length(new_size);
+        if (old_length != new_length) {
+            // past the reservation (or shrunk below half of it): the kernel moves the page tables, the payload is not copied
+            ptr = mremap(ptr, old_length, new_length, MREMAP_MAYMOVE);
+            if (ptr == MAP_FAILED) { return NULL; }
+            #if defined(MADV_HUGEPAGE)
+                if (new_length > old_length) { madvise(ptr, new_length, MADV_HUGEPAGE); }
+            #endif // defined(MADV_HUGEPAGE)
+        }
+        if (new_size < old_size) {
+            // give the whole pages past the new size back, they read as zeroes if they are touched again
+            size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+            size_t start = (new_size + page_size - 1) & ~(page_size - 1);
+            size_t end = old_size < new_length ? old_size : new_length;
+            if (end > start) { madvise((char *)ptr + start, end - start, MADV_DONTNEED); }
+        }
+        return ptr;
+    }
+
+    static void __vector_mmap_free(void *context, void *ptr, size_t size) {
+        (void)context;
+        munmap(ptr, __vector_mmap_length(size));
+    }
+
+    const Vector_Allocator Vector_mmap_allocator = { __vector_mmap_alloc, __vector_mmap_realloc, __vector_mmap_free, NULL };
+#endif // defined(__linux__)
+
+#define __VECTOR_PIPELINE_FILTER 0
+#define __VECTOR_PIPELINE_MAP    1
+#define __VECTOR_PIPELINE_SKIP   2
+#define __VECTOR_PIPELINE_TAKE   3
+
+// the pipeline runs the vector block by block: each stage goes over the whole block before the next one, the block stays in the cache
+#define __VECTOR_PIPELINE_BLOCK_LENGTH 256
+
+// the mapped blocks up to this size live on the stack while the pipeline runs, bigger ones in a buffer allocated once per run
+#define __VECTOR_PIPELINE_STACK_SCRATCH_SIZE (4 * 1024)
+
+// receives the elements leaving the pipeline, block by block, returns false to stop it
+typedef bool (*__vector_pipeline_sink_fn)(const void *const *elements, size_t count, void *state);
+
+/**
+ * Internal
+ * 
+ * Returns the size of the elements leaving a pipeline
+ * @param pipeline [Vector_Pipeline*] - The pipeline
+ * @return         [size_t]           - The element size of the last stage, of the source vector without any stage
+ */
+static size_t __vector_pipeline_output_size(const Vector_Pipeline *pipeline) {
+    if (pipeline->stage_count > 0) { return pipeline->stages[pipeline->stage_count - 1].element_size; }
+    return __VECTOR_TRAIT(__vector_get_header(pipeline->vec_ptr), element_size);
+}
+
+/**
+ * Internal
+ * 
+ * Appends a stage to a pipeline
+ * @param pipeline [Vector_Pipeline*]         - The pipeline
+ * @param kind     [unsigned int]             - The __VECTOR_PIPELINE_* kind of the stage
+ * @return         [__Vector_Pipeline_Stage*] - The stage, its element size is the one of the previous stage
+ */
+static __Vector_Pipeline_Stage *__vector_pipeline_add_stage(Vector_Pipeline *pipeline, unsigned int kind) {
+    assertf(pipeline != NULL, "ERROR: Pipeline is NULL\n");
+    assertf(pipeline->stage_count < VECTOR_PIPELINE_MAX_STAGES, "ERROR: Pipeline has more than %d stages\n", VECTOR_PIPELINE_MAX_STAGES);
+    __Vector_Pipeline_Stage *stage = &pipeline->stages[pipeline->stage_count];
+    stage->kind = kind;
+    stage->predicate_fn = NULL;
+    stage->map_fn = NULL;
+    stage->context = NULL;
+    stage->element_size = __vector_pipeline_output_size(pipeline);
+    stage->count = 0;
+    pipeline->stage_count++;
+    return stage;
+}
+
+/**
+ * Internal
+ * 
+ * Runs a pipeline in a single pass over the source vector, a block of elements goes through all the stages before the next block is read
+ * The elements are handled through pointers: a filter compacts the pointers, a map writes its block to a scratch buffer and points to it
+ * @param pipeline [Vector_Pipeline*]          - The pipeline
+ * @param sink     [__vector_pipeline_sink_fn] - Receives the elements leaving the pipeline
+ * @param state    [void*]                     - Passed to the sink
+ * @throw          [assert]                    - If the pipeline is NULL
+ * @throw          [assert]                    - If the scratch buffer of big mapped elements cannot be allocated
+ */
+static void __vector_pipeline_run(const Vector_Pipeline *pipeline, __vector_pipeline_sink_fn sink, void *state) {
+    assertf(pipeline != NULL, "ERROR: Pipeline is NULL\n");
+    __Vector_Header *header = __vector_get_header(pipeline->vec_ptr);
+    size_t length = header->length;
+    size_t element_size = __VECTOR_TRAIT(header, element_size);
+    const char *data = (const char *)*(void **)pipeline->vec_ptr;
+
+    // two blocks for the mapped elements, a map stage never writes to the block it reads from
+    size_t scratch_size = 0;
+    for (size_t s = 0; s < pipeline->stage_count; s++) {
+        size_t block_size = pipeline->stages[s].element_size * __VECTOR_PIPELINE_BLOCK_LENGTH;
+        if (pipeline->stages[s].kind == __VECTOR_PIPELINE_MAP && block_size > scratch_size) { scratch_size = block_size; }
+    }
+    max_align_t stack_scratch[2][__VECTOR_PIPELINE_STACK_SCRATCH_SIZE / sizeof(max_align_t)];
+    char *scratch[2] = { (char *)stack_scratch[0], (char *)stack_scratch[1] };
+    char *heap_scratch = NULL;
+    if (scratch_size > sizeof(stack_scratch[0])) {
+        heap_scratch = (char *)malloc(2 * scratch_size);
+        assertf(heap_scratch != NULL, "ERROR: Could not allocate the pipeline scratch buffer\n");
+        scratch[0] = heap_scratch;
+        scratch[1] = heap_scratch + scratch_size;
+    }
+
+    const void *elements[__VECTOR_PIPELINE_BLOCK_LENGTH];
+    size_t counters[VECTOR_PIPELINE_MAX_STAGES] = { 0 };
+    bool done = false;
+    for (size_t start = 0; start < length && !done; start += __VECTOR_PIPELINE_BLOCK_LENGTH) {
+        size_t count = length - start < __VECTOR_PIPELINE_BLOCK_LENGTH ? length - start : __VECTOR_PIPELINE_BLOCK_LENGTH;
+        for (size_t i = 0; i < count; i++) { elements[i] = data + (start + i) * element_size; }
+        int buffer = 0;
+        for (size_t s = 0; s < pipeline->stage_count && count > 0; s++) {
+            const __Vector_Pipeline_Stage *stage = &pipeline->stages[s];
+            switch (stage->kind) {
+                case __VECTOR_PIPELINE_FILTER: {
+                    size_t kept = 0;
+                    for (size_t i = 0; i < count; i++) {
+                        if (stage->predicate_fn(elements[i], stage->context)) { elements[kept++] = elements[i]; }
+                    }
+                    count = kept;
+                    break;
+                }
+                case __VECTOR_PIPELINE_MAP: {
+                    char *result = scratch[buffer];
+                    for (size_t i = 0; i < count; i++, result += stage->element_size) {
+                        stage->map_fn(elements[i], result, stage->context);
+                        elements[i] = result;
+                    }
+                    buffer ^= 1;
+                    break;
+                }
+                case __VECTOR_PIPELINE_SKIP: {
+                    size_t skipped = stage->count - counters[s] < count ? stage->count - counters[s] : count;
+                    if (skipped > 0) {
+                        memmove(elements, elements + skipped, (count - skipped) * sizeof(*elements));
+                        counters[s] += skipped;
+                        count -= skipped;
+                    }
+                    break;
+                }
+                case __VECTOR_PIPELINE_TAKE: {
+                    // nothing gets past an exhausted take, so the rest of the vector is not read
+                    if (stage->count - counters[s] <= count) {
+                        count = stage->count - counters[s];
+                        done = true;
+                    }
+                    counters[s] += count;
+                    break;
+                }
+            }
+        }
+        if (count > 0 && !sink(elements, count, state)) { done = true; }
+    }
+    free(heap_scratch);
+}
+
+void Vector_pipeline_init(Vector_Pipeline *pipeline, void *vec_ptr) {
+    void **temp_ptr = (void **)vec_ptr;
+    assertf(pipeline != NULL, "ERROR: Pipeline is NULL\n");
+    assertf( temp_ptr != NULL, "ERROR: NULL is not a valid vector\n");
+    assertf(*temp_ptr != NULL, "ERROR: Vector is NULL\n");
+    pipeline->vec_ptr = vec_ptr;
+    pipeline->stage_count = 0;
+}
+
+void Vector_pipeline_filter(Vector_Pipeline *pipeline, Vector_pipeline_predicate_fn predicate_fn, void *context) {
+    assertf(predicate_fn != NULL, "ERROR: Predicate is NULL\n");
+    __Vector_Pipeline_Stage *stage = __vector_pipeline_add_stage(pipeline, __VECTOR_PIPELINE_FILTER);
+    stage->predicate_fn = predicate_fn;
+    stage->context = context;
+}
+
+void Vector_pipeline_map(Vector_Pipeline *pipeline, Vector_pipeline_map_fn map_fn, size_t element_size, void *context) {
+    assertf(map_fn != NULL, "ERROR: Mapper is NULL\n");
+    assertf(element_size > 0, "ERROR: Element size is 0\n");
+    __Vector_Pipeline_Stage *stage = __vector_pipeline_add_stage(pipeline, __VECTOR_PIPELINE_MAP);
+    stage->map_fn = map_fn;
+    stage->context = context;
+    stage->element_size = element_size;
+}
+
+void Vector_pipeline_skip(Vector_Pipeline *pipeline, size_t count) {
+    __vector_pipeline_add_stage(pipeline, __VECTOR_PIPELINE_SKIP)->count = count;
+}
+
+void Vector_pipeline_take(Vector_Pipeline *pipeline, size_t count) {
+    __vector_pipeline_add_stage(pipeline, __VECTOR_PIPELINE_TAKE)->count = count;
+}
+
+// the state of Vector_pipeline_collect: the output vector is allocated with room for every element that can leave the pipeline
+typedef struct __Vector_Pipeline_Collect {
+    char *data;
+    size_t length;
+    size_t element_size;
+} __Vector_Pipeline_Collect;
+
+/**
+ * Internal
+ * 
+ * Appends a block of elements to the vector being collected
+ * @param elements [void**] - The elements leaving the pipeline
+ * @param count    [size_t] - The number of elements
+ * @param state    [void*]  - The state of the terminal operation
+ * @return         [bool]   - False to stop the pipeline
+ */
+static bool __vector_pipeline_collect_sink(const void *const *elements, size_t count, void *state) {
+    __Vector_Pipeline_Collect *collect = (__Vector_Pipeline_Collect *)state;
+    char *destination = collect->data + collect->length * collect->element_size;
+    for (size_t i = 0; i < count; i++, destination += collect->element_size) { memcpy(destination, elements[i], collect->element_size); }
+    collect->length += count;
+    return true;
+}
+
+void *Vector_pipeline_collect(const Vector_Pipeline *pipeline) {
+    assertf(pipeline != NULL, "ERROR: Pipeline is NULL\n");
+    // every element of the vector yields at most one output, and no more than the smallest take lets through
+    size_t capacity = Vector_get_length(pipeline->vec_ptr);
+    for (size_t s = 0; s < pipeline->stage_count; s++) {
+        if (pipeline->stages[s].kind == __VECTOR_PIPELINE_TAKE && pipeline->stages[s].count < capacity) { capacity = pipeline->stages[s].count; }
+    }
+    __Vector_Pipeline_Collect collect;
+    collect.element_size = __vector_pipeline_output_size(pipeline);
+    collect.data = (char *)__vector_init_from(pipeline->vec_ptr, collect.element_size, capacity);
+    collect.length = 0;
+    __vector_pipeline_run(pipeline, __vector_pipeline_collect_sink, &collect);
+    void *new_vec = collect.data;
+    __Vector_Header *header = __vector_get_header(&new_vec);
+    header->length = collect.length;
+    if (collect.length < header->capacity) { Vector_shrink_to_fit(&new_vec); }
+    return new_vec;
+}
+
+// the state of Vector_pipeline_reduce
+typedef struct __Vector_Pipeline_Reduce {
+    Vector_pipeline_reduce_fn reduce_fn;
+    void *accumulator;
+    void *context;
+} __Vector_Pipeline_Reduce;
+
+/**
+ * Internal
+ * 
+ * Folds a block of elements into the accumulator
+ * @param elements [void**] - The elements leaving the pipeline
+ * @param count    [size_t] - The number of elements
+ * @param state    [void*]  - The state of the terminal operation
+ * @return         [bool]   - False to stop the pipeline
+ */
+static bool __vector_pipeline_reduce_sink(const void *const *elements, size_t count, void *state) {
+    __Vector_Pipeline_Reduce *reduce = (__Vector_Pipeline_Reduce *)state;
+    for (size_t i = 0; i < count; i++) { reduce->reduce_fn(reduce->accumulator, elements[i], reduce->context); }
+    return true;
+}
+
+void Vector_pipeline_reduce(const Vector_Pipeline *pipeline, Vector_pipeline_reduce_fn reduce_fn, void *accumulator, void *context) {
+    assertf(reduce_fn != NULL, "ERROR: Reducer is NULL\n");
+    assertf(accumulator != NULL, "ERROR: Accumulator is NULL\n");
+    __Vector_Pipeline_Reduce reduce = { reduce_fn, accumulator, context };
+    __vector_pipeline_run(pipeline, __vector_pipeline_reduce_sink, &reduce);
+}
+
+/**
+ * Internal
+ * 
+ * Counts a block of elements
+ * @param elements [void**] - The elements leaving the pipeline
+ * @param count    [size_t] - The number of elements
+ * @param state    [void*]  - The state of the terminal operation
+ * @return         [bool]   - False to stop the pipeline
+ */
+static bool __vector_pipeline_count_sink(const void *const *elements, size_t count, void *state) {
+    (void)elements;
+    (*(size_t *)state) += count;
+    return true;
+}
+
+size_t Vector_pipeline_count(const Vector_Pipeline *pipeline) {
+    size_t count = 0;
+    __vector_pipeline_run(pipeline, __vector_pipeline_count_sink, &count);
+    return count;
+}
+
+// the state of Vector_pipeline_any and Vector_pipeline_all: the pipeline stops at the first element whose predicate result is `stop_on`
+typedef struct __Vector_Pipeline_Match {
+    Vector_pipeline_predicate_fn predicate_fn;
+    void *context;
+    bool stop_on;
+    bool stopped;
+} __Vector_Pipeline_Match;
+
+/**
+ * Internal
+ * 
+ * Applies the predicate of any/all to a block of elements, stopping the pipeline at the first decisive one
+ * @param elements [void**] - The elements leaving the pipeline
+ * @param count    [size_t] - The number of elements
+ * @param state    [void*]  - The state of the terminal operation
+ * @return         [bool]   - False to stop the pipeline
+ */
+static bool __vector_pipeline_match_sink(const void *const *elements, size_t count, void *state) {
+    __Vector_Pipeline_Match *match = (__Vector_Pipeline_Match *)state;
+    for (size_t i = 0; i < count; i++) {
+        if (match->predicate_fn(elements[i], match->context) == match->stop_on) {
+            match->stopped = true;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Vector_pipeline_any(const Vector_Pipeline *pipeline, Vector_pipeline_predicate_fn predicate_fn, void *context) {
+    assertf(predicate_fn != NULL, "ERROR: Predicate is NULL\n");
+    __Vector_Pipeline_Match match = { predicate_fn, context, true, false };
+    __vector_pipeline_run(pipeline, __vector_pipeline_match_sink, &match);
+    return match.stopped;
+}
+
+bool Vector_pipeline_all(const Vector_Pipeline *pipeline, Vector_pipeline_predicate_fn predicate_fn, void *context) {
+    assertf(predicate_fn != NULL, "ERROR: Predicate is NULL\n");
+    __Vector_Pipeline_Match match = { predicate_fn, context, false, false };
+    __vector_pipeline_run(pipeline, __vector_pipeline_match_sink, &match);
+    return !match.stopped;
+}
+
+// the state of Vector_pipeline_foreach
+typedef struct __Vector_Pipeline_Foreach {
+    Vector_pipeline_foreach_fn foreach_fn;
+    void *context;
+} __Vector_Pipeline_Foreach;
+
+/**
+ * Internal
+ * 
+ * Calls the function of Vector_pipeline_foreach on a block of elements
+ * @param elements [void**] - The elements leaving the pipeline
+ * @param count    [size_t] - The number of elements
+ * @param state    [void*]  - The state of the terminal operation
+ * @return         [bool]   - False to stop the pipeline
+ */
+static bool __vector_pipeline_foreach_sink(const void *const *elements, size_t count, void *state) {
+    __Vector_Pipeline_Foreach *foreach = (__Vector_Pipeline_Foreach *)state;
+    for (size_t i = 0; i < count; i++) { foreach->foreach_fn(elements[i], foreach->context); }
+    return true;
+}
+
+void Vector_pipeline_foreach(const Vector_Pipeline *pipeline, Vector_pipeline_foreach_fn foreach_fn, void *context) {
+    assertf(foreach_fn != NULL, "ERROR: Function is NULL\n");
+    __Vector_Pipeline_Foreach foreach = { foreach_fn, context };
+    __vector_pipeline_run(pipeline, __vector_pipeline_foreach_sink, &foreach);
+}
+
+/**
+ * Internal
+ * 
+ * Returns the size of the keys of a scalar type
+ * @param key_type [Vector_Scalar_Type] - The type
+ * @return         [size_t]             - The size in bytes
+ */
+static size_t __vector_scalar_size(Vector_Scalar_Type key_type) {
+    switch (key_type) {
+        case VECTOR_SCALAR_U8:  case VECTOR_SCALAR_I8:  return 1;
+        case VECTOR_SCALAR_U16: case VECTOR_SCALAR_I16: return 2;
+        case VECTOR_SCALAR_U32: case VECTOR_SCALAR_I32: case VECTOR_SCALAR_F32: return 4;
+        case VECTOR_SCALAR_U64: case VECTOR_SCALAR_I64: case VECTOR_SCALAR_F64: return 8;
+    }
+    assertf(false, "ERROR: Invalid scalar type: %d\n", (int)key_type);
+    return 0;
+}
+
+#define __VECTOR_RADIX_UNSIGNED 0
+#define __VECTOR_RADIX_SIGNED   1
+#define __VECTOR_RADIX_FLOAT    2
+
+/**
+ * Internal
+ * 
+ * Reads a key as an unsigned integer ordered the same way as the key
+ * @param key      [void*]        - The key
+ * @param key_size [size_t]       - The size of the key
+ * @param kind     [unsigned int] - __VECTOR_RADIX_UNSIGNED, __VECTOR_RADIX_SIGNED or __VECTOR_RADIX_FLOAT
+ * @return         [uint64_t]     - Signed keys with their sign bit flipped, negative floats with all their bits flipped, positive ones with their sign bit
+ */
+static uint64_t __vector_radix_load(const void *key, size_t key_size, unsigned int kind) {
+    uint64_t bits;
+    switch (key_size) {
+        case 1:  { uint8_t  value; memcpy(&value, key, 1); bits = value; break; }
+        case 2:  { uint16_t value; memcpy(&value, key, 2); bits = value; break; }
+        case 4:  { uint32_t value; memcpy(&value, key, 4); bits = value; break; }
+        default: { memcpy(&bits, key, 8); break; }
+    }
+    uint64_t sign = (uint64_t)1 << (key_size * 8 - 1);
+    if (kind == __VECTOR_RADIX_SIGNED) { return bits ^ sign; }
+    if (kind == __VECTOR_RADIX_FLOAT) { return (bits & sign) ? ~bits & (sign | (sign - 1)) : bits | sign; }
+    return bits;
+}
+
+/**
+ * Internal
+ * 
+ * Moves the elements to their bucket of one byte of the key, keeping the order of the elements of a bucket
+ * @param src          [char*]               - The elements
+ * @param dst          [char*]               - Where the elements are moved
+ * @param length       [size_t]              - The number of elements
+ * @param element_size [size_t]              - The size of the elements
+ * @param key_size     [size_t]              - The size of the key
+ * @param kind         [unsigned int]        - The kind of the key (__VECTOR_RADIX_*)
+ * @param key_fn       [Vector_radix_key_fn] - Returns the key of an element, NULL when the element is the key
+ * @param shift        [size_t]              - The position of the byte in the key, in bits
+ * @param offsets      [size_t*]             - The index in dst of the next element of each bucket
+ */
+static __VECTOR_ALWAYS_INLINE void __vector_radix_scatter(const char *src, char *dst, size_t length, size_t element_size, size_t key_size, unsigned int kind, Vector_radix_key_fn key_fn, size_t shift, size_t *offsets) {
+    for (size_t i = 0; i < length; i++) {
+        const char *element = src + i * element_size;
+        uint64_t key = __vector_radix_load(key_fn != NULL ? key_fn(element) : element, key_size, kind);
+        memcpy(dst + offsets[(key >> shift) & 0xff]++ * element_size, element, element_size);
+    }
+}
+
+/**
+ * Internal
+ * 
+ * The LSD radix sort of Vector_sort_radix and Vector_sort_radix_by_key
+ * @param vec_ptr  [T**]                 - A reference to the vector
+ * @param key_type [Vector_Scalar_Type]  - The type of the key
+ * @param key_fn   [Vector_radix_key_fn] - Returns the key of an element, NULL when the element is the key
+ */
+static void __vector_sort_radix(void *vec_ptr, Vector_Scalar_Type key_type, Vector_radix_key_fn key_fn) {
+    __Vector_Header *header = __vector_get_header(vec_ptr);
+    size_t length = header->length;
+    if (length < 2) { return; }
+    size_t element_size = __VECTOR_TRAIT(header, element_size);
+    size_t key_size = __vector_scalar_size(key_type);
+    unsigned int kind = __VECTOR_RADIX_UNSIGNED;
+    if (key_type == VECTOR_SCALAR_F32 || key_type == VECTOR_SCALAR_F64) { kind = __VECTOR_RADIX_FLOAT; }
+    else if (key_type == VECTOR_SCALAR_I8 || key_type == VECTOR_SCALAR_I16 || key_type == VECTOR_SCALAR_I32 || key_type == VECTOR_SCALAR_I64) { kind = __VECTOR_RADIX_SIGNED; }
+    char *vec = (char *)*(void **)vec_ptr;
+
+    // the histograms of every byte of the key in a single scan
+    size_t counts[8][256];
+    memset(counts, 0, sizeof(counts[0]) * key_size);
+    for (size_t i = 0; i < length; i++) {
+        const char *element = vec + i * element_size;
+        uint64_t key = __vector_radix_load(key_fn != NULL ? key_fn(element) : element, key_size, kind);
+        for (size_t byte = 0; byte < key_size; byte++) { counts[byte][(key >> (byte * 8)) & 0xff]++; }
+    }
+
+    const Vector_Allocator *allocator = __vector_derived_allocator(__VECTOR_TRAIT(header, allocator));
+    char *scratch = NULL;
+    char *src = vec;
+    for (size_t byte = 0; byte < key_size; byte++) {
+        size_t *count = counts[byte];
+        // every key has the same byte: the pass would not move anything
+        if (count[(__vector_radix_load(key_fn != NULL ? key_fn(vec) : vec, key_size, kind) >> (byte * 8)) & 0xff] == length) { continue; }
+        if (scratch == NULL) {
+            scratch = (char *)__vector_allocator_alloc(allocator, length * element_size);
+            assertf(scratch != NULL, "ERROR: Failed to allocate memory for the radix sort\n");
+        }
+        size_t offset = 0;
+        for (size_t bucket = 0; bucket < 256; bucket++) {
+            size_t bucket_count = count[bucket];
+            count[bucket] = offset;
+            offset += bucket_count;
+        }
+        char *dst = src == vec ? scratch : vec;
+        // __vector_radix_scatter is forced inline, so the common element sizes get a scatter loop of their own with a fixed size copy
+        switch (element_size) {
+            case 4:  __vector_radix_scatter(src, dst, length, 4, key_size, kind, key_fn, byte * 8, count); break;
+            case 8:  __vector_radix_scatter(src, dst, length, 8, key_size, kind, key_fn, byte * 8, count); break;
+            default: __vector_radix_scatter(src, dst, length, element_size, key_size, kind, key_fn, byte * 8, count); break;
+        }
+        src = dst;
+    }
+    if (scratch == NULL) { return; }
+    if (src != vec) { memcpy(vec, src, length * element_size); }
+    __vector_allocator_free(allocator, scratch, length * element_size);
+}
+
+void Vector_sort_radix(void *vec_ptr, Vector_Scalar_Type key_type) {
+    void **temp_ptr = (void **)vec_ptr;
+    assertf( temp_ptr != NULL, "ERROR: NULL is not a valid vector\n");
+    assertf(*temp_ptr != NULL, "ERROR: Vector is NULL\n");
+    size_t element_size = __VECTOR_TRAIT(__vector_get_header(vec_ptr), element_size);
+    assertf(element_size == __vector_scalar_size(key_type), "ERROR: Element size: %zu is not the size of the key type: %zu\n", element_size, __vector_scalar_size(key_type));
+    __vector_sort_radix(vec_ptr, key_type, NULL);
+}
+
+void Vector_sort_radix_by_key(void *vec_ptr, Vector_Scalar_Type key_type, Vector_radix_key_fn key_fn) {
+    void **temp_ptr = (void **)vec_ptr;
+    assertf( temp_ptr != NULL, "ERROR: NULL is not a valid vector\n");
+    assertf(*temp_ptr != NULL, "ERROR: Vector is NULL\n");
+    assertf(key_fn != NULL, "ERROR: Key function is NULL\n");
+    __vector_sort_radix(vec_ptr, key_type, key_fn);
+}
+
+// the most threads the parallel functions run on, the calling one included
+#define __VECTOR_PARALLEL_MAX_THREADS 64
+
+// Vector_parallel_foreach/map/reduce cut the vector in about this many chunks per thread (unless the grain size makes them bigger),
+// so a thread done early has chunks left to steal
+#define __VECTOR_PARALLEL_CHUNKS_PER_THREAD 16
+
+// the work of a parallel function on the indices [begin, end), receives the state shared by the threads
+typedef void (*__vector_parallel_job_fn)(void *state, size_t begin, size_t end);
+
+static __VECTOR_ATOMIC(size_t) __vector_parallel_thread_count; // 0 until the first use, then Vector_parallel_set_thread_count or one per online processor
+static __VECTOR_ATOMIC(size_t) __vector_parallel_grain_size = { VECTOR_PARALLEL_GRAIN_SIZE };
+
+/**
+ * Internal
+ * 
+ * Returns the number of online processors
+ * @return [size_t] - At least 1, 1 without VECTOR_THREADS
+ */
+static size_t __vector_hardware_threads(void) {
+    #if VECTOR_THREADS && defined(_SC_NPROCESSORS_ONLN)
+        long count = sysconf(_SC_NPROCESSORS_ONLN);
+        if (count > 0) { return (size_t)(count < __VECTOR_PARALLEL_MAX_THREADS ? count : __VECTOR_PARALLEL_MAX_THREADS); }
+    #endif // VECTOR_THREADS && defined(_SC_NPROCESSORS_ONLN)
+    return 1;
+}
+
+#if VECTOR_THREADS
+    // the chunks [begin, end) a thread has left to run, the other threads steal from the end
+    typedef struct __Vector_Parallel_Range {
+        size_t begin;
+        size_t end;
+        __Vector_Spin_Lock lock;
+    } __Vector_Parallel_Range;
+
+    // the pool: its threads are started by the first parallel call and wait for the next job between the calls,
+    // the calling thread runs its share of the job as the thread 0, one job runs at a time (a parallel call made during a job runs serially)
+    static pthread_mutex_t __vector_parallel_job_mutex = PTHREAD_MUTEX_INITIALIZER; // held by the thread running a job on the pool
+    static pthread_mutex_t __vector_parallel_mutex = PTHREAD_MUTEX_INITIALIZER; // guards the generation, the pending count and stopping
+    static pthread_cond_t __vector_parallel_wake = PTHREAD_COND_INITIALIZER; // a new job or stopping
+    static pthread_cond_t __vector_parallel_done = PTHREAD_COND_INITIALIZER; // the last thread finished the job
+    static pthread_t __vector_parallel_threads[__VECTOR_PARALLEL_MAX_THREADS];
+    static size_t __vector_parallel_seen_generation[__VECTOR_PARALLEL_MAX_THREADS]; // the generation a thread was started at
+    static size_t __vector_parallel_started_count = 0; // the threads of the pool, the calling thread excluded
+    static bool __vector_parallel_started = false;
+    static size_t __vector_parallel_generation = 0; // incremented for every job
+    static size_t __vector_parallel_pending = 0; // the threads of the pool still running the job
+    static bool __vector_parallel_stopping = false;
+    static pthread_once_t __vector_parallel_atfork_once = PTHREAD_ONCE_INIT;
+
+    // the job being run
+    static __vector_parallel_job_fn __vector_parallel_job = NULL;
+    static void *__vector_parallel_state = NULL;
+    static size_t __vector_parallel_count = 0;
+    static size_t __vector_parallel_chunk_length = 0;
+    static size_t __vector_parallel_worker_count = 0;
+    static __Vector_Parallel_Range __vector_parallel_ranges[__VECTOR_PARALLEL_MAX_THREADS];
+
+    /**
+     * Internal
+     * 
+     * Runs the chunks of a thread, then the chunks it steals from the others (half of what a thread has left, from its end) until none is left
+     * @param worker_index [size_t] - The index of the thread
+     */
+    static void __vector_parallel_work(size_t worker_index) {
+        __Vector_Parallel_Range *own = &__vector_parallel_ranges[worker_index];
+        for (;;) {
+            __VECTOR_SPIN_LOCK(own->lock);
+            if (own->begin < own->end) {
+                size_t chunk = own->begin++;
+                __VECTOR_SPIN_UNLOCK(own->lock);
+                size_t begin = chunk * __vector_parallel_chunk_length;
+                size_t end = begin + __vector_parallel_chunk_length < __vector_parallel_count ? begin + __vector_parallel_chunk_length : __vector_parallel_count;
+                __vector_parallel_job(__vector_parallel_state, begin, end);
+                continue;
+            }
+            __VECTOR_SPIN_UNLOCK(own->lock);
+            size_t stolen_begin = 0, stolen_end = 0;
+            for (size_t i = 1; i < __vector_parallel_worker_count && stolen_begin == stolen_end; i++) {
+                __Vector_Parallel_Range *victim = &__vector_parallel_ranges[(worker_index + i) % __vector_parallel_worker_count];
+                __VECTOR_SPIN_LOCK(victim->lock);
+                if (victim->begin < victim->end) {
+                    stolen_end = victim->end;
+                    victim->end -= (victim->end - victim->begin + 1) / 2;
+                    stolen_begin = victim->end;
+                }
+                __VECTOR_SPIN_UNLOCK(victim->lock);
+            }
+            if (stolen_begin == stolen_end) { return; }
+            __VECTOR_SPIN_LOCK(own->lock);
+            own->begin = stolen_begin;
+            own->end = stolen_end;
+            __VECTOR_SPIN_UNLOCK(own->lock);
+        }
+    }
+
+    static void *__vector_parallel_thread_main(void *arg) {
+        size_t worker_index = (size_t)(uintptr_t)arg;
+        pthread_mutex_lock(&__vector_parallel_mutex);
+        size_t seen_generation = __vector_parallel_seen_generation[worker_index];
+        for (;;) {
+            while (!__vector_parallel_stopping && __vector_parallel_generation == seen_generation) {
+                pthread_cond_wait(&__vector_parallel_wake, &__vector_parallel_mutex);
+            }
+            if (__vector_parallel_stopping) { break; }
+            seen_generation = __vector_parallel_generation;
+            pthread_mutex_unlock(&__vector_parallel_mutex);
+            __vector_parallel_work(worker_index);
+            pthread_mutex_lock(&__vector_parallel_mutex);
+            if (--__vector_parallel_pending == 0) { pthread_cond_signal(&__vector_parallel_done); }
+        }
+        pthread_mutex_unlock(&__vector_parallel_mutex);
+        return NULL;
+    }
+
+    /**
+     * Internal
+     * 
+     * Resets the pool in the child of a fork: only the forking thread is copied, so the threads of the pool are gone and
+     * the mutexes may be held by threads that no longer exist, the next parallel call starts a new pool
+     */
+    static void __vector_parallel_atfork_child(void) {
+        pthread_mutex_init(&__vector_parallel_job_mutex, NULL);
+        pthread_mutex_init(&__vector_parallel_mutex, NULL);
+        pthread_cond_init(&__vector_parallel_wake, NULL);
+        pthread_cond_init(&__vector_parallel_done, NULL);
+        for (size_t i = 0; i < __VECTOR_PARALLEL_MAX_THREADS; i++) { __VECTOR_STORE_RELEASE(__vector_parallel_ranges[i].lock, 0); }
+        __vector_parallel_started = false;
+        __vector_parallel_started_count = 0;
+        __vector_parallel_pending = 0;
+        __vector_parallel_stopping = false;
+    }
+
+    /**
+     * Internal
+     * 
+     * Registers the fork handler of the pool, called once
+     */
+    static void __vector_parallel_register_atfork(void) {
+        pthread_atfork(NULL, NULL, __vector_parallel_atfork_child);
+    }
+
+    /**
+     * Internal
+     * 
+     * Starts the threads of the pool if they are not running, the job mutex is held
+     * @return [size_t] - The number of threads running the jobs, the calling one included
+     */
+    static size_t __vector_parallel_start(void) {
+        if (!__vector_parallel_started) {
+            pthread_once(&__vector_parallel_atfork_once, __vector_parallel_register_atfork);
+            if (__vector_parallel_thread_count == 0) { __VECTOR_STORE_RELEASE(__vector_parallel_thread_count, __vector_hardware_threads()); }
+            __vector_parallel_started = true;
+            __vector_parallel_started_count = 0;
+            for (size_t i = 1; i < __vector_parallel_thread_count; i++) {
+                // a thread that cannot be created leaves the pool smaller
+                __vector_parallel_seen_generation[i] = __vector_parallel_generation;
+                if (pthread_create(&__vector_parallel_threads[i], NULL, __vector_parallel_thread_main, (void *)(uintptr_t)i) != 0) { break; }
+                __vector_parallel_started_count++;
+            }
+        }
+        return __vector_parallel_started_count + 1;
+    }
+
+    /**
+     * Internal
+     * 
+     * Stops and joins the threads of the pool, the job mutex is held
+     */
+    static void __vector_parallel_stop(void) {
+        if (!__vector_parallel_started) { return; }
+        pthread_mutex_lock(&__vector_parallel_mutex);
+        __vector_parallel_stopping = true;
+        pthread_cond_broadcast(&__vector_parallel_wake);
+        pthread_mutex_unlock(&__vector_parallel_mutex);
+        for (size_t i = 1; i <= __vector_parallel_started_count; i++) { pthread_join(__vector_parallel_threads[i], NULL); }
+        __vector_parallel_stopping = false;
+        __vector_parallel_started = false;
+        __vector_parallel_started_count = 0;
+    }
+#endif // VECTOR_THREADS
+
+/**
+ * Internal
+ * 
+ * Runs a job over the indices [0, count) on the pool, cut in chunks of chunk_length indices spread over the threads,
+ * returns when the whole range is done
+ * Runs the whole range on the calling thread when it is a single chunk, the pool has a single thread or it is running another job
+ * @param count        [size_t]                   - The number of indices
+ * @param chunk_length [size_t]                   - The number of indices of a chunk, at least 1
+ * @param job          [__vector_parallel_job_fn] - The job, called with the ranges of indices
+ * @param state        [void*]                    - Passed to the job
+ */
+static void __vector_parallel_for(size_t count, size_t chunk_length, __vector_parallel_job_fn job, void *state) {
+    if (count == 0) { return; }
+    #if VECTOR_THREADS
+        size_t chunk_count = (count + chunk_length - 1) / chunk_length;
+        if (chunk_count > 1 && pthread_mutex_trylock(&__vector_parallel_job_mutex) == 0) {
+            size_t worker_count = __vector_parallel_start();
+            if (worker_count > 1) {
+                __vector_parallel_job = job;
+                __vector_parallel_state = state;
+                __vector_parallel_count = count;
+                __vector_parallel_chunk_length = chunk_length;
+                __vector_parallel_worker_count = worker_count;
+                for (size_t i = 0; i < worker_count; i++) {
+                    __vector_parallel_ranges[i].begin = chunk_count * i / worker_count;
+                    __vector_parallel_ranges[i].end = chunk_count * (i + 1) / worker_count;
+                }
+                pthread_mutex_lock(&__vector_parallel_mutex);
+                __vector_parallel_pending = worker_count - 1;
+                __vector_parallel_generation++;
+                pthread_cond_broadcast(&__vector_parallel_wake);
+                pthread_mutex_unlock(&__vector_parallel_mutex);
+                __vector_parallel_work(0);
+                pthread_mutex_lock(&__vector_parallel_mutex);
+                while (__vector_parallel_pending > 0) { pthread_cond_wait(&__vector_parallel_done, &__vector_parallel_mutex); }
+                pthread_mutex_unlock(&__vector_parallel_mutex);
+                pthread_mutex_unlock(&__vector_parallel_job_mutex);
+                return;
+            }
+            pthread_mutex_unlock(&__vector_parallel_job_mutex);
+        }
+    #else
+        (void)chunk_length;
+    #endif // VECTOR_THREADS
+    job(state, 0, count);
+}
+
+/**
+ * Internal
+ * 
+ * Returns the chunk length of Vector_parallel_foreach/map/reduce for a vector: the grain size, or bigger to make about
+ * __VECTOR_PARALLEL_CHUNKS_PER_THREAD chunks per thread
+ * @param length [size_t] - The length of the vector
+ * @return       [size_t] - The number of elements of a chunk
+ */
+static size_t __vector_parallel_chunk_length_for(size_t length) {
+    size_t chunk_count = Vector_parallel_get_thread_count() * __VECTOR_PARALLEL_CHUNKS_PER_THREAD;
+    size_t chunk_length = (length + chunk_count - 1) / chunk_count;
+    // read once: the chunk length is fixed when the job is submitted, a concurrent Vector_parallel_set_grain_size applies to the next job
+    size_t grain_size = Vector_parallel_get_grain_size();
+    return chunk_length > grain_size ? chunk_length : grain_size;
+}
+
+void Vector_parallel_set_thread_count(size_t thread_count) {
+    if (thread_count == 0) { thread_count = __vector_hardware_threads(); }
+    if (thread_count > __VECTOR_PARALLEL_MAX_THREADS) { thread_count = __VECTOR_PARALLEL_MAX_THREADS; }
+    #if VECTOR_THREADS
+        pthread_mutex_lock(&__vector_parallel_job_mutex);
+        __vector_parallel_stop();
+        __VECTOR_STORE_RELEASE(__vector_parallel_thread_count, thread_count);
+        pthread_mutex_unlock(&__vector_parallel_job_mutex);
+    #else
+        __vector_parallel_thread_count = thread_count;
+    #endif // VECTOR_THREADS
+}
+
+size_t Vector_parallel_get_thread_count(void) {
+    // not locked: the parallel functions call it while a job may be running
+    size_t thread_count = __VECTOR_LOAD_ACQUIRE(__vector_parallel_thread_count);
+    return thread_count != 0 ? thread_count : __vector_hardware_threads();
+}
+
+void Vector_parallel_set_grain_size(size_t grain_size) {
+    assertf(grain_size > 0, "ERROR: Grain size must be at least 1\n");
+    __VECTOR_STORE_RELEASE(__vector_parallel_grain_size, grain_size);
+}
+
+size_t Vector_parallel_get_grain_size(void) {
+    return __VECTOR_LOAD_ACQUIRE(__vector_parallel_grain_size);
+}
+
+void Vector_parallel_shutdown(void) {
+    #if VECTOR_THREADS
+        pthread_mutex_lock(&__vector_parallel_job_mutex);
+        __vector_parallel_stop();
+        pthread_mutex_unlock(&__vector_parallel_job_mutex);
+    #endif // VECTOR_THREADS
+}
+
+/**
+ * Internal
+ * 
+ * Copies an element, with a fixed size copy for the common element sizes
+ * @param dst          [void*]  - Where the element is copied
+ * @param src          [void*]  - The element
+ * @param element_size [size_t] - The size of the element
+ */
+static void __vector_copy_element(void *dst, const void *src, size_t element_size) {
+    switch (element_size) {
+        case 4:  memcpy(dst, src, 4); break;
+        case 8:  memcpy(dst, src, 8); break;
+        case 16: memcpy(dst, src, 16); break;
+        default: memcpy(dst, src, element_size); break;
+    }
+}
+
+/**
+ * Internal
+ * 
+ * Merges two sorted ranges, the elements of the first one go first when equal
+ * @param a            [char*]             - The first range
+ * @param a_length     [size_t]            - Its number of elements
+ * @param b            [char*]             - The second range
+ * @param b_length     [size_t]            - Its number of elements
+ * @param dst          [char*]             - Where the a_length + b_length elements are written (not overlapping the ranges)
+ * @param element_size [size_t]            - The size of the elements
+ * @param compare_fn   [Vector_compare_fn] - The compare function
+ */
+static void __vector_merge_ranges(const char *a, size_t a_length, const char *b, size_t b_length, char *dst, size_t element_size, Vector_compare_fn compare_fn) {
+    const char *a_end = a + a_length * element_size, *b_end = b + b_length * element_size;
+    while (a < a_end && b < b_end) {
+        if (compare_fn(b, a) < 0) { __vector_copy_element(dst, b, element_size); b += element_size; }
+        else                      { __vector_copy_element(dst, a, element_size); a += element_size; }
+        dst += element_size;
+    }
+    if (a < a_end) { memcpy(dst, a, (size_t)(a_end - a)); }
+    if (b < b_end) { memcpy(dst, b, (size_t)(b_end - b)); }
+}
+
+// the runs a merge sort of Vector_sort_parallel starts from are sorted with an insertion sort
+#define __VECTOR_MERGE_SORT_RUN_LENGTH 32
+
+/**
+ * Internal
+ * 
+ * Sorts a range with a stable bottom-up merge sort, runs of __VECTOR_MERGE_SORT_RUN_LENGTH sorted by insertion first
+ * @param data         [char*]             - The range, sorted in place
+ * @param scratch      [char*]             - A buffer of the size of the range
+ * @param length       [size_t]            - The number of elements
+ * @param element_size [size_t]            - The size of the elements
+ * @param compare_fn   [Vector_compare_fn] - The compare function
+ */
+static void __vector_merge_sort_range(char *data, char *scratch, size_t length, size_t element_size, Vector_compare_fn compare_fn) {
+    // the scratch buffer holds the element being inserted
+    for (size_t start = 0; start < length; start += __VECTOR_MERGE_SORT_RUN_LENGTH) {
+        size_t end = start + __VECTOR_MERGE_SORT_RUN_LENGTH < length ? start + __VECTOR_MERGE_SORT_RUN_LENGTH : length;
+        for (size_t i = start + 1; i < end; i++) {
+            char *element = data + i * element_size;
+            if (compare_fn(element, element - element_size) >= 0) { continue; }
+            size_t j = i - 1;
+            while (j > start && compare_fn(element, data + (j - 1) * element_size) < 0) { j--; }
+            memcpy(scratch, element, element_size);
+            memmove(data + (j + 1) * element_size, data + j * element_size, (i - j) * element_size);
+            memcpy(data + j * element_size, scratch, element_size);
+        }
+    }
+    char *src = data, *dst = scratch;
+    for (size_t width = __VECTOR_MERGE_SORT_RUN_LENGTH; width < length; width *= 2) {
+        for (size_t start = 0; start < length; start += 2 * width) {
+            size_t mid = start + width < length ? start + width : length;
+            size_t end = start + 2 * width < length ? start + 2 * width : length;
+            __vector_merge_ranges(src + start * element_size, mid - start, src + mid * element_size, end - mid, dst + start * element_size, element_size, compare_fn);
+        }
+        char *temp = src; src = dst; dst = temp;
+    }
+    if (src != data) { memcpy(data, src, length * element_size); }
+}
+
+/**
+ * Internal
+ * 
+ * Finds how many elements of the first range go before the index k of the merge of two sorted ranges (the first range going first when equal)
+ * @param a            [char*]             - The first range
+ * @param a_length     [size_t]            - Its number of elements
+ * @param b            [char*]             - The second range
+ * @param b_length     [size_t]            - Its number of elements
+ * @param k            [size_t]            - The index in the merged range, up to a_length + b_length
+ * @param element_size [size_t]            - The size of the elements
+ * @param compare_fn   [Vector_compare_fn] - The compare function
+ * @return             [size_t]            - i, the first k elements of the merge being a[0..i) and b[0..k - i)
+ */
+static size_t __vector_merge_split(const char *a, size_t a_length, const char *b, size_t b_length, size_t k, size_t element_size, Vector_compare_fn compare_fn) {
+    size_t low = k > b_length ? k - b_length : 0;
+    size_t high = k < a_length ? k : a_length;
+    while (low < high) {
+        size_t i = low + (high - low) / 2;
+        // a[i] goes before b[k - i - 1]: more than i elements of a are in the first k
+        if (compare_fn(b + (k - i - 1) * element_size, a + i * element_size) >= 0) { low = i + 1; }
+        else { high = i; }
+    }
+    return low;
+}
+
+// the state shared by the threads of Vector_sort_parallel
+typedef struct __Vector_Parallel_Sort {
+    char *vec;
+    char *src; // the sorted runs of the round
+    char *dst; // where the round merges them
+    size_t length;
+    size_t element_size;
+    Vector_compare_fn compare_fn;
+    size_t task_count; // the number of chunks, and of shares of a merge round
+    size_t bounds[__VECTOR_PARALLEL_MAX_THREADS + 1]; // the runs are [bounds[i], bounds[i + 1])
+    size_t run_count;
+} __Vector_Parallel_Sort;
+
+/**
+ * Internal
+ * 
+ * Sorts chunks of Vector_sort_parallel, they become the first runs
+ * @param state [__Vector_Parallel_Sort*] - The sort
+ * @param begin [size_t]                  - The index of the first chunk
+ * @param end   [size_t]                  - The index past the last chunk
+ */
+static void __vector_parallel_sort_chunks(void *state, size_t begin, size_t end) {
+    __Vector_Parallel_Sort *sort = (__Vector_Parallel_Sort *)state;
+    size_t element_size = sort->element_size;
+    for (size_t chunk = begin; chunk < end; chunk++) {
+        size_t start = sort->bounds[chunk], length = sort->bounds[chunk + 1] - start;
+        if (sort->src != sort->vec) { memcpy(sort->src + start * element_size, sort->vec + start * element_size, length * element_size); }
+        // the chunk is sorted in src, with its part of dst as the scratch buffer
+        __vector_merge_sort_range(sort->src + start * element_size, sort->dst + start * element_size, length, element_size, sort->compare_fn);
+    }
+}
+
+/**
+ * Internal
+ * 
+ * Writes shares of a merge round of Vector_sort_parallel, the share i being the elements [length * i / task_count, length * (i + 1) / task_count)
+ * of dst, merged from the pairs of runs of src covering them (a run left without a pair is copied)
+ * @param state [__Vector_Parallel_Sort*] - The sort
+ * @param begin [size_t]                  - The index of the first share
+ * @param end   [size_t]                  - The index past the last share
+ */
+static void __vector_parallel_sort_merge(void *state, size_t begin, size_t end) {
+    __Vector_Parallel_Sort *sort = (__Vector_Parallel_Sort *)state;
+    size_t element_size = sort->element_size;
+    size_t share_start = sort->length * begin / sort->task_count;
+    size_t share_end = sort->length * end / sort->task_count;
+    for (size_t run = 0; run < sort->run_count; run += 2) {
+        size_t start = sort->bounds[run];
+        size_t mid = sort->bounds[run + 1];
+        size_t end = run + 2 <= sort->run_count ? sort->bounds[run + 2] : mid;
+        if (end <= share_start) { continue; }
+        if (start >= share_end) { break; }
+        size_t from = (share_start > start ? share_start : start) - start;
+        size_t to = (share_end < end ? share_end : end) - start;
+        const char *a = sort->src + start * element_size, *b = sort->src + mid * element_size;
+        size_t a_length = mid - start, b_length = end - mid;
+        size_t a_from = __vector_merge_split(a, a_length, b, b_length, from, element_size, sort->compare_fn);
+        size_t a_to = __vector_merge_split(a, a_length, b, b_length, to, element_size, sort->compare_fn);
+        __vector_merge_ranges(a + a_from * element_size, a_to - a_from, b + (from - a_from) * element_size, (to - a_to) - (from - a_from),
+                              sort->dst + (start + from) * element_size, element_size, sort->compare_fn);
+    }
+}
+
+void Vector_sort_parallel(void *vec_ptr, Vector_compare_fn compare_fn, size_t thread_count) {
+    void **temp_ptr = (void **)vec_ptr;
+    assertf( temp_ptr != NULL, "ERROR: NULL is not a valid vector\n");
+    assertf(*temp_ptr != NULL, "ERROR: Vector is NULL\n");
+    assertf(compare_fn != NULL, "ERROR: Compare function is NULL\n");
+    __Vector_Header *header = __vector_get_header(vec_ptr);
+    size_t length = header->length;
+    if (length < 2) { return; }
+    size_t element_size = __VECTOR_TRAIT(header, element_size);
+    if (thread_count == 0) { thread_count = Vector_parallel_get_thread_count(); }
+    if (thread_count > length / VECTOR_PARALLEL_SORT_MIN_CHUNK) { thread_count = length / VECTOR_PARALLEL_SORT_MIN_CHUNK; }
+    if (thread_count > __VECTOR_PARALLEL_MAX_THREADS) { thread_count = __VECTOR_PARALLEL_MAX_THREADS; }
+    if (thread_count == 0) { thread_count = 1; }
+
+    const Vector_Allocator *allocator = __vector_derived_allocator(__VECTOR_TRAIT(header, allocator));
+    char *scratch = (char *)__vector_allocator_alloc(allocator, length * element_size);
+    assertf(scratch != NULL, "ERROR: Failed to allocate memory for the parallel sort\n");
+    char *vec = (char *)*temp_ptr;
+    if (thread_count == 1) {
+        __vector_merge_sort_range(vec, scratch, length, element_size, compare_fn);
+        __vector_allocator_free(allocator, scratch, length * element_size);
+        return;
+    }
+
+    __Vector_Parallel_Sort sort;
+    sort.length = length;
+    sort.element_size = element_size;
+    sort.compare_fn = compare_fn;
+    sort.task_count = thread_count;
+    sort.run_count = thread_count;
+    for (size_t i = 0; i <= thread_count; i++) { sort.bounds[i] = length * i / thread_count; }
+    // every round halves the number of runs, the chunks are sorted where the last round ends up in the vector
+    size_t rounds = 0;
+    for (size_t runs = thread_count; runs > 1; runs = (runs + 1) / 2) { rounds++; }
+    sort.src = rounds % 2 == 0 ? vec : scratch;
+    sort.dst = rounds % 2 == 0 ? scratch : vec;
+    sort.vec = vec;
+    __vector_parallel_for(thread_count, 1, __vector_parallel_sort_chunks, &sort);
+    while (sort.run_count > 1) {
+        __vector_parallel_for(thread_count, 1, __vector_parallel_sort_merge, &sort);
+        size_t run_count = 0;
+        for (size_t i = 0; i < sort.run_count; i += 2) { sort.bounds[run_count++] = sort.bounds[i]; }
+        sort.bounds[run_count] = length;
+        sort.run_count = run_count;
+        char *temp = sort.src; sort.src = sort.dst; sort.dst = temp;
+    }
+    __vector_allocator_free(allocator, scratch, length * element_size);
+}
+
+// the state of Vector_parallel_foreach
+typedef struct __Vector_Parallel_Foreach {
+    char *vec;
+    size_t element_size;
+    Vector_parallel_foreach_fn foreach_fn;
+    void *context;
+} __Vector_Parallel_Foreach;
+
+static void __vector_parallel_foreach_job(void *state, size_t begin, size_t end) {
+    __Vector_Parallel_Foreach *foreach = (__Vector_Parallel_Foreach *)state;
+    char *element = foreach->vec + begin * foreach->element_size;
+    for (size_t i = begin; i < end; i++, element += foreach->element_size) { foreach->foreach_fn(element, foreach->context); }
+}
+
+void Vector_parallel_foreach(void *vec_ptr, Vector_parallel_foreach_fn foreach_fn, void *context) {
+    void **temp_ptr = (void **)vec_ptr;
+    assertf( temp_ptr != NULL, "ERROR: NULL is not a valid vector\n");
+    assertf(*temp_ptr != NULL, "ERROR: Vector is NULL\n");
+    assertf(foreach_fn != NULL, "ERROR: Function is NULL\n");
+    __Vector_Header *header = __vector_get_header(vec_ptr);
+    size_t length = header->length;
+    __Vector_Parallel_Foreach foreach = { (char *)*temp_ptr, __VECTOR_TRAIT(header, element_size), foreach_fn, context };
+    __vector_parallel_for(length, __vector_parallel_chunk_length_for(length), __vector_parallel_foreach_job, &foreach);
+}
+
+// the state of Vector_parallel_map
+typedef struct __Vector_Parallel_Map {
+    const char *vec;
+    size_t element_size;
+    char *result;
+    size_t result_element_size;
+    Vector_parallel_map_fn map_fn;
+    void *context;
+} __Vector_Parallel_Map;
+
+static void __vector_parallel_map_job(void *state, size_t begin, size_t end) {
+    __Vector_Parallel_Map *map = (__Vector_Parallel_Map *)state;
+    const char *element = map->vec + begin * map->element_size;
+    char *result = map->result + begin * map->result_element_size;
+    for (size_t i = begin; i < end; i++, element += map->element_size, result += map->result_element_size) {
+        map->map_fn(element, result, map->context);
+    }
+}
+
+void *Vector_parallel_map(void *vec_ptr, Vector_parallel_map_fn map_fn, size_t element_size, void *context) {
+    void **temp_ptr = (void **)vec_ptr;
+    assertf( temp_ptr != NULL, "ERROR: NULL is not a valid vector\n");
+    assertf(*temp_ptr != NULL, "ERROR: Vector is NULL\n");
+    assertf(map_fn != NULL, "ERROR: Function is NULL\n");
+    __Vector_Header *header = __vector_get_header(vec_ptr);
+    size_t length = header->length;
+    void *result = __vector_init_from(vec_ptr, element_size, length);
+    __Vector_Parallel_Map map = { (const char *)*temp_ptr, __VECTOR_TRAIT(header, element_size), (char *)result, element_size, map_fn, context };
+    __vector_parallel_for(length, __vector_parallel_chunk_length_for(length), __vector_parallel_map_job, &map);
+    __vector_get_header(&result)->length = length;
+    return result;
+}
+
+// the state of Vector_parallel_reduce
+typedef struct __Vector_Parallel_Reduce {
+    const char *vec;
+    size_t element_size;
+    char *partials; // one accumulator per chunk
+    size_t accumulator_size;
+    size_t chunk_length;
+    Vector_parallel_reduce_fn reduce_fn;
+    void *context;
+} __Vector_Parallel_Reduce;
+
+static void __vector_parallel_reduce_job(void *state, size_t begin, size_t end) {
+    __Vector_Parallel_Reduce *reduce = (__Vector_Parallel_Reduce *)state;
+    // a range run on the calling thread alone may span several chunks, it folds into the partial of its first one
+    void *accumulator = reduce->partials + (begin / reduce->chunk_length) * reduce->accumulator_size;
+    const char *element = reduce->vec + begin * reduce->element_size;
+    for (size_t i = begin; i < end; i++, element += reduce->element_size) { reduce->reduce_fn(accumulator, element, reduce->context); }
+}
+
+void Vector_parallel_reduce(void *vec_ptr, Vector_parallel_reduce_fn reduce_fn, Vector_parallel_combine_fn combine_fn, void *accumulator, size_t accumulator_size, void *context) {
+    void **temp_ptr = (void **)vec_ptr;
+    assertf( temp_ptr != NULL, "ERROR: NULL is not a valid vector\n");
+    assertf(*temp_ptr != NULL, "ERROR: Vector is NULL\n");
+    assertf(reduce_fn != NULL, "ERROR: Reduce function is NULL\n");
+    assertf(combine_fn != NULL, "ERROR: Combine function is NULL\n");
+    assertf(accumulator != NULL, "ERROR: Accumulator is NULL\n");
+    __Vector_Header *header = __vector_get_header(vec_ptr);
+    size_t length = header->length;
+    size_t chunk_length = __vector_parallel_chunk_length_for(length);
+    size_t chunk_count = (length + chunk_length - 1) / chunk_length;
+    if (chunk_count <= 1) {
+        // a single chunk folds straight into the accumulator
+        const char *element = (const char *)*temp_ptr;
+        size_t element_size = __VECTOR_TRAIT(header, element_size);
+        for (size_t i = 0; i < length; i++, element += element_size) { reduce_fn(accumulator, element, context); }
+        return;
+    }
+    // every chunk starts from the initial accumulator, the partials are combined in the order of the chunks
+    const Vector_Allocator *allocator = __vector_derived_allocator(__VECTOR_TRAIT(header, allocator));
+    char *partials = (char *)__vector_allocator_alloc(allocator, chunk_count * accumulator_size);
+    assertf(partials != NULL, "ERROR: Failed to allocate memory for the partial results\n");
+    for (size_t i = 0; i < chunk_count; i++) { memcpy(partials + i * accumulator_size, accumulator, accumulator_size); }
+    __Vector_Parallel_Reduce reduce = { (const char *)*temp_ptr, __VECTOR_TRAIT(header, element_size), partials, accumulator_size, chunk_length, reduce_fn, context };
+    __vector_parallel_for(length, chunk_length, __vector_parallel_reduce_job, &reduce);
+    memcpy(accumulator, partials, accumulator_size);
+    for (size_t i = 1; i < chunk_count; i++) { combine_fn(accumulator, partials + i * accumulator_size, context); }
+    __vector_allocator_free(allocator, partials, chunk_count * accumulator_size);
+}
+
+// the state of Vector_parallel_filter
+typedef struct __Vector_Parallel_Filter {
+    const char *vec;
+    size_t element_size;
+    size_t chunk_length;
+    bool *matches; // the result of the predicate for every element
+    size_t *offsets; // the number of matches of every chunk, then where its first match goes in the result
+    char *result;
+    Vector_parallel_predicate_fn predicate_fn;
+    void *context;
+} __Vector_Parallel_Filter;
+
+/**
+ * Internal
+ * 
+ * The first pass of Vector_parallel_filter: evaluates the predicate on the chunks of a range and counts their matches
+ * @param state [__Vector_Parallel_Filter*] - The filter
+ * @param begin [size_t]                    - The first element, the first of a chunk
+ * @param end   [size_t]                    - The element past the last one
+ */
+static void __vector_parallel_filter_count_job(void *state, size_t begin, size_t end) {
+    __Vector_Parallel_Filter *filter = (__Vector_Parallel_Filter *)state;
+    // a range run on the calling thread alone spans several chunks
+    for (size_t chunk_begin = begin; chunk_begin < end; chunk_begin += filter->chunk_length) {
+        size_t chunk_end = chunk_begin + filter->chunk_length < end ? chunk_begin + filter->chunk_length : end;
+        const char *element = filter->vec + chunk_begin * filter->element_size;
+        size_t count = 0;
+        for (size_t i = chunk_begin; i < chunk_end; i++, element += filter->element_size) {
+            bool match = filter->predicate_fn(element, filter->context);
+            filter->matches[i] = match;
+            count += match;
+        }
+        filter->offsets[chunk_begin / filter->chunk_length] = count;
+    }
+}
+
+/**
+ * Internal
+ * 
+ * The second pass of Vector_parallel_filter: copies the matches of the chunks of a range to the result, from the offset of their chunk
+ * @param state [__Vector_Parallel_Filter*] - The filter
+ * @param begin [size_t]                    - The first element, the first of a chunk
+ * @param end   [size_t]                    - The element past the last one
+ */
+static void __vector_parallel_filter_scatter_job(void *state, size_t begin, size_t end) {
+    __Vector_Parallel_Filter *filter = (__Vector_Parallel_Filter *)state;
+    size_t element_size = filter->element_size;
+    for (size_t chunk_begin = begin; chunk_begin < end; chunk_begin += filter->chunk_length) {
+        size_t chunk_end = chunk_begin + filter->chunk_length < end ? chunk_begin + filter->chunk_length : end;
+        char *dst = filter->result + filter->offsets[chunk_begin / filter->chunk_length] * element_size;
+        const char *element = filter->vec + chunk_begin * element_size;
+        for (size_t i = chunk_begin; i < chunk_end; i++, element += element_size) {
+            if (!filter->matches[i]) { continue; }
+            __vector_copy_element(dst, element, element_size);
+            dst += element_size;
+        }
+    }
+}
+
+void *Vector_parallel_filter(void *vec_ptr, Vector_parallel_predicate_fn predicate_fn, void *context) {
+    void **temp_ptr = (void **)vec_ptr;
+    assertf( temp_ptr != NULL, "ERROR: NULL is not a valid vector\n");
+    assertf(*temp_ptr != NULL, "ERROR: Vector is NULL\n");
+    assertf(predicate_fn != NULL, "ERROR: Predicate is NULL\n");
+    __Vector_Header *header = __vector_get_header(vec_ptr);
+    size_t length = header->length;
+    size_t element_size = __VECTOR_TRAIT(header, element_size);
+    if (length == 0) { return __vector_init_from(vec_ptr, element_size, 0); }
+    size_t chunk_length = __vector_parallel_chunk_length_for(length);
+    size_t chunk_count = (length + chunk_length - 1) / chunk_length;
+    const Vector_Allocator *allocator = __vector_derived_allocator(__VECTOR_TRAIT(header, allocator));
+    bool *matches = (bool *)__vector_allocator_alloc(allocator, length * sizeof(bool));
+    size_t *offsets = (size_t *)__vector_allocator_alloc(allocator, chunk_count * sizeof(size_t));
+    assertf(matches != NULL && offsets != NULL, "ERROR: Failed to allocate memory for the parallel filter\n");
+    __Vector_Parallel_Filter filter = { (const char *)*temp_ptr, element_size, chunk_length, matches, offsets, NULL, predicate_fn, context };
+    __vector_parallel_for(length, chunk_length, __vector_parallel_filter_count_job, &filter);
+    // exclusive prefix sum of the counts
+    size_t match_count = 0;
+    for (size_t i = 0; i < chunk_count; i++) {
+        size_t count = offsets[i];
+        offsets[i] = match_count;
+        match_count += count;
+    }
+    void *result = __vector_init_from(vec_ptr, element_size, match_count);
+    filter.result = (char *)result;
+    __vector_parallel_for(length, chunk_length, __vector_parallel_filter_scatter_job, &filter);
+    __vector_get_header(&result)->length = match_count;
+    __vector_allocator_free(allocator, offsets, chunk_count * sizeof(size_t));
+    __vector_allocator_free(allocator, matches, length * sizeof(bool));
+    return result;
+}
+
+// the typed searches compare a whole register of elements at a time with GCC/clang vector extensions, the width of the register is the widest
+// the compiler targets (16 bytes for SSE2/NEON, 32 with -mavx2, 64 with -mavx512bw), a wider one would be split into scalar operations
+#if defined(__GNUC__) || defined(__clang__)
+    #define __VECTOR_SIMD 1
+    #if defined(__AVX512BW__)
+        #define __VECTOR_SIMD_WIDTH 64
+    #elif defined(__AVX2__)
+        #define __VECTOR_SIMD_WIDTH 32
+    #else
+        #define __VECTOR_SIMD_WIDTH 16
+    #endif // defined(__AVX512BW__)
+
+    /**
+     * Internal
+     * 
+     * Advances __i__ over the blocks of 4 registers of elements holding no element equal to __value__,
+     * it stops at the block holding the first one or at the tail
+     * @param __T__      [type]   - The type of the elements
+     * @param __U__      [type]   - The unsigned integer type of the size of __T__
+     * @param __data__   [__T__*] - The elements
+     * @param __length__ [size_t] - The number of elements
+     * @param __value__  [__T__]  - The value
+     * @param __i__      [size_t] - The index to advance
+     */
+    #define __VECTOR_SIMD_FIND_EQ(__T__, __U__, __data__, __length__, __value__, __i__) do {                                  \
+        typedef __T__ __values__ __attribute__((vector_size(__VECTOR_SIMD_WIDTH)));                                         \
+        typedef __U__ __mask__ __attribute__((vector_size(__VECTOR_SIMD_WIDTH)));                                           \
+        typedef uint64_t __words__ __attribute__((vector_size(__VECTOR_SIMD_WIDTH)));                                       \
+        const size_t __lanes__ = __VECTOR_SIMD_WIDTH / sizeof(__T__);                                                       \
+        __values__ __needle__ = (__values__){ 0 } + (__value__);                                                            \
+        for (; (__i__) + 4 * __lanes__ <= (__length__); (__i__) += 4 * __lanes__) {                                         \
+            __values__ __a__, __b__, __c__, __d__;                                                                          \
+            memcpy(&__a__, (__data__) + (__i__), __VECTOR_SIMD_WIDTH);                                                      \
+            memcpy(&__b__, (__data__) + (__i__) + __lanes__, __VECTOR_SIMD_WIDTH);                                          \
+            memcpy(&__c__, (__data__) + (__i__) + 2 * __lanes__, __VECTOR_SIMD_WIDTH);                                      \
+            memcpy(&__d__, (__data__) + (__i__) + 3 * __lanes__, __VECTOR_SIMD_WIDTH);                                      \
+            __words__ __found__ = (__words__)((__mask__)(__a__ == __needle__) | (__mask__)(__b__ == __needle__)             \
+                                            | (__mask__)(__c__ == __needle__) | (__mask__)(__d__ == __needle__));           \
+            uint64_t __any__ = 0;                                                                                           \
+            for (size_t __w__ = 0; __w__ < __VECTOR_SIMD_WIDTH / 8; __w__++) { __any__ |= __found__[__w__]; }               \
+            if (__any__ != 0) { break; }                                                                                    \
+        }                                                                                                                   \
+    } while (0)
+
+    /**
+     * Internal
+     * 
+     * Counts the elements e of the registers of elements of __data__ for which __condition__ holds, advances __i__ to the tail
+     * @param __T__          [type]   - The type of the elements
+     * @param __U__          [type]   - The unsigned integer type of the size of __T__
+     * @param __data__       [__T__*] - The elements
+     * @param __length__     [size_t] - The number of elements
+     * @param __condition__  [expr]   - The condition on a register __e__ of elements, with __low__ and __high__ broadcast from __low_value__ and __high_value__
+     * @param __low_value__  [__T__]  - Broadcast to __low__
+     * @param __high_value__ [__T__]  - Broadcast to __high__
+     * @param __i__          [size_t] - The index to advance
+     * @param __count__      [size_t] - The count to add to
+     */
+    #define __VECTOR_SIMD_COUNT(__T__, __U__, __data__, __length__, __condition__, __low_value__, __high_value__, __i__, __count__) do { \
+        typedef __T__ __values__ __attribute__((vector_size(__VECTOR_SIMD_WIDTH)));                                         \
+        typedef __U__ __mask__ __attribute__((vector_size(__VECTOR_SIMD_WIDTH)));                                           \
+        const size_t __lanes__ = __VECTOR_SIMD_WIDTH / sizeof(__T__);                                                       \
+        /* a lane counts up to the largest __U__ before the counts are added up */                                          \
+        const size_t __flush__ = sizeof(__T__) == 1 ? 255 : 65535;                                                          \
+        __values__ __low__ = (__values__){ 0 } + (__low_value__);                                                           \
+        __values__ __high__ = (__values__){ 0 } + (__high_value__);                                                         \
+        (void)__low__; (void)__high__;                                                                                      \
+        __mask__ __counts__ = (__mask__){ 0 };                                                                              \
+        size_t __steps__ = 0;                                                                                               \
+        for (; (__i__) + __lanes__ <= (__length__); (__i__) += __lanes__) {                                                 \
+            __values__ __e__;                                                                                               \
+            memcpy(&__e__, (__data__) + (__i__), __VECTOR_SIMD_WIDTH);                                                      \
+            __counts__ -= (__mask__)(__condition__); /* a true lane is all ones: -1 */                                      \
+            if (++__steps__ == __flush__) {                                                                                 \
+                for (size_t __l__ = 0; __l__ < __lanes__; __l__++) { (__count__) += __counts__[__l__]; }                    \
+                __counts__ = (__mask__){ 0 };                                                                               \
+                __steps__ = 0;                                                                                              \
+            }                                                                                                               \
+        }                                                                                                                   \
+        for (size_t __l__ = 0; __l__ < __lanes__; __l__++) { (__count__) += __counts__[__l__]; }                            \
+    } while (0)
+#else
+    #define __VECTOR_SIMD 0
+    #define __VECTOR_SIMD_FIND_EQ(__T__, __U__, __data__, __length__, __value__, __i__) ((void)0)
+    #define __VECTOR_SIMD_COUNT(__T__, __U__, __data__, __length__, __condition__, __low_value__, __high_value__, __i__, __count__) ((void)0)
+#endif // defined(__GNUC__) || defined(__clang__)
+
+/**
+ * Internal
+ * 
+ * Defines the typed searches of one scalar type: __vector_find_eq_<suffix>, __vector_count_eq_<suffix> and __vector_count_range_<suffix>,
+ * the SIMD loops do the bulk of the elements, a scalar loop the tail
+ * @param __suffix__ [name] - The suffix of the functions
+ * @param __T__      [type] - The type of the elements
+ * @param __U__      [type] - The unsigned integer type of the size of __T__
+ */
+#define __VECTOR_DEFINE_TYPED_SEARCHES(__suffix__, __T__, __U__)                                                            \
+    static size_t __vector_find_eq_##__suffix__(const __T__ *data, size_t length, __T__ value) {                            \
+        size_t i = 0;                                                                                                       \
+        __VECTOR_SIMD_FIND_EQ(__T__, __U__, data, length, value, i);                                                        \
+        for (; i < length; i++) { if (data[i] == value) { return i; } }                                                     \
+        return VECTOR_NPOS;                                                                                                 \
+    }                                                                                                                       \
+    static size_t __vector_count_eq_##__suffix__(const __T__ *data, size_t length, __T__ value) {                           \
+        size_t i = 0, count = 0;                                                                                            \
+        __VECTOR_SIMD_COUNT(__T__, __U__, data, length, __e__ == __low__, value, value, i, count);                          \
+        for (; i < length; i++) { count += data[i] == value; }                                                              \
+        return count;                                                                                                       \
+    }                                                                                                                       \
+    static size_t __vector_count_range_##__suffix__(const __T__ *data, size_t length, __T__ low, __T__ high) {              \
+        size_t i = 0, count = 0;                                                                                            \
+        __VECTOR_SIMD_COUNT(__T__, __U__, data, length, (__e__ >= __low__) & (__e__ <= __high__), low, high, i, count);     \
+        for (; i < length; i++) { count += data[i] >= low && data[i] <= high; }                                             \
+        return count;                                                                                                       \
+    }
+
+__VECTOR_DEFINE_TYPED_SEARCHES(u8, uint8_t, uint8_t)
+__VECTOR_DEFINE_TYPED_SEARCHES(i8, int8_t, uint8_t)
+__VECTOR_DEFINE_TYPED_SEARCHES(u16, uint16_t, uint16_t)
+__VECTOR_DEFINE_TYPED_SEARCHES(i16, int16_t, uint16_t)
+__VECTOR_DEFINE_TYPED_SEARCHES(u32, uint32_t, uint32_t)
+__VECTOR_DEFINE_TYPED_SEARCHES(i32, int32_t, uint32_t)
+__VECTOR_DEFINE_TYPED_SEARCHES(u64, uint64_t, uint64_t)
+__VECTOR_DEFINE_TYPED_SEARCHES(i64, int64_t, uint64_t)
+__VECTOR_DEFINE_TYPED_SEARCHES(f32, float, uint32_t)
+__VECTOR_DEFINE_TYPED_SEARCHES(f64, double, uint64_t)
+
+/**
+ * Internal
+ * 
+ * Checks a vector for the typed searches and returns its elements
+ * @param vec_ptr [T**]                - A reference to the vector
+ * @param type    [Vector_Scalar_Type] - The type of the elements
+ * @param length  [size_t*]            - Receives the length of the vector
+ * @return        [void*]              - The elements
+ */
+static const void *__vector_typed_search_data(void *vec_ptr, Vector_Scalar_Type type, size_t *length) {
+    void **temp_ptr = (void **)vec_ptr;
+    assertf( temp_ptr != NULL, "ERROR: NULL is not a valid vector\n");
+    assertf(*temp_ptr != NULL, "ERROR: Vector is NULL\n");
+    __Vector_Header *header = __vector_get_header(vec_ptr);
+    size_t element_size = __VECTOR_TRAIT(header, element_size);
+    assertf(element_size == __vector_scalar_size(type), "ERROR: Element size: %zu is not the size of the type: %zu\n", element_size, __vector_scalar_size(type));
+    *length = header->length;
+    return *temp_ptr;
+}
+
+// runs __call__ with __T__ value read from the pointer __value_ptr__ into value (and __high_ptr__ into high) for the scalar type __type__
+#define __VECTOR_TYPED_SEARCH_DISPATCH(__type__, __value_ptr__, __high_ptr__, __call__) do {                                    \
+    switch (__type__) {                                                                                                     \
+        case VECTOR_SCALAR_U8:  { uint8_t  value, high; memcpy(&value, (__value_ptr__), 1); memcpy(&high, (__high_ptr__), 1); return __call__(u8, uint8_t); }   \
+        case VECTOR_SCALAR_I8:  { int8_t   value, high; memcpy(&value, (__value_ptr__), 1); memcpy(&high, (__high_ptr__), 1); return __call__(i8, int8_t); }    \
+        case VECTOR_SCALAR_U16: { uint16_t value, high; memcpy(&value, (__value_ptr__), 2); memcpy(&high, (__high_ptr__), 2); return __call__(u16, uint16_t); } \
+        case VECTOR_SCALAR_I16: { int16_t  value, high; memcpy(&value, (__value_ptr__), 2); memcpy(&high, (__high_ptr__), 2); return __call__(i16, int16_t); }  \
+        case VECTOR_SCALAR_U32: { uint32_t value, high; memcpy(&value, (__value_ptr__), 4); memcpy(&high, (__high_ptr__), 4); return __call__(u32, uint32_t); } \
+        case VECTOR_SCALAR_I32: { int32_t  value, high; memcpy(&value, (__value_ptr__), 4); memcpy(&high, (__high_ptr__), 4); return __call__(i32, int32_t); }  \
+        case VECTOR_SCALAR_U64: { uint64_t value, high; memcpy(&value, (__value_ptr__), 8); memcpy(&high, (__high_ptr__), 8); return __call__(u64, uint64_t); } \
+        case VECTOR_SCALAR_I64: { int64_t  value, high; memcpy(&value, (__value_ptr__), 8); memcpy(&high, (__high_ptr__), 8); return __call__(i64, int64_t); }  \
+        case VECTOR_SCALAR_F32: { float    value, high; memcpy(&value, (__value_ptr__), 4); memcpy(&high, (__high_ptr__), 4); return __call__(f32, float); }    \
+        case VECTOR_SCALAR_F64: { double   value, high; memcpy(&value, (__value_ptr__), 8); memcpy(&high, (__high_ptr__), 8); return __call__(f64, double); }   \
+    }                                                                                                                       \
+} while (0)
+
+size_t Vector_find_eq(void *vec_ptr, Vector_Scalar_Type type, const void *value_ptr) {
+    size_t length;
+    const void *data = __vector_typed_search_data(vec_ptr, type, &length);
+    assertf(value_ptr != NULL, "ERROR: Value is NULL\n");
+    if (type == VECTOR_SCALAR_U8 || type == VECTOR_SCALAR_I8) {
+        const void *found = memchr(data, *(const unsigned char *)value_ptr, length);
+        return found != NULL ? (size_t)((const char *)found - (const char *)data) : VECTOR_NPOS;
+    }
+    #define __VECTOR_FIND_EQ_CALL(__suffix__, __T__) __vector_find_eq_##__suffix__((const __T__ *)data, length, value)
+    __VECTOR_TYPED_SEARCH_DISPATCH(type, value_ptr, value_ptr, __VECTOR_FIND_EQ_CALL);
+    #undef __VECTOR_FIND_EQ_CALL
+    return VECTOR_NPOS;
+}
+
+size_t Vector_count_eq(void *vec_ptr, Vector_Scalar_Type type, const void *value_ptr) {
+    size_t length;
+    const void *data = __vector_typed_search_data(vec_ptr, type, &length);
+    assertf(value_ptr != NULL, "ERROR: Value is NULL\n");
+    #define __VECTOR_COUNT_EQ_CALL(__suffix__, __T__) __vector_count_eq_##__suffix__((const __T__ *)data, length, value)
+    __VECTOR_TYPED_SEARCH_DISPATCH(type, value_ptr, value_ptr, __VECTOR_COUNT_EQ_CALL);
+    #undef __VECTOR_COUNT_EQ_CALL
+    return 0;
+}
+
+size_t Vector_count_range(void *vec_ptr, Vector_Scalar_Type type, const void *low_ptr, const void *high_ptr) {
+    size_t length;
+    const void *data = __vector_typed_search_data(vec_ptr, type, &length);
+    assertf(low_ptr != NULL && high_ptr != NULL, "ERROR: Bound is NULL\n");
+    #define __VECTOR_COUNT_RANGE_CALL(__suffix__, __T__) __vector_count_range_##__suffix__((const __T__ *)data, length, value, high)
+    __VECTOR_TYPED_SEARCH_DISPATCH(type, low_ptr, high_ptr, __VECTOR_COUNT_RANGE_CALL);
+    #undef __VECTOR_COUNT_RANGE_CALL
+    return 0;
 }
@@ -8,27 +8,214 @@ extern "C" {    // prevent name mangling
 #endif         // C++ support
 
 #include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 #include <stdbool.h>
 
 #include "./modules/assertf/assertf.h"
 
 #define VECTOR_DEFAULT_INITIAL_CAPACITY 4
+#define VECTOR_DEFAULT_GROWTH_FACTOR 2.0
+#define VECTOR_DEFAULT_SHRINK_DIVISOR 4
+
+// define VECTOR_COMPACT_HEADER as 1 (the same way for vector.c and the code including vector.h) for a 32 byte header instead of 80:
+// 32 bit length and capacity, and the configuration of the vector (element size, functions, allocator, ...) in a traits record shared by the vectors having the same one
+#ifndef VECTOR_COMPACT_HEADER
+    #define VECTOR_COMPACT_HEADER 0
+#endif // VECTOR_COMPACT_HEADER
+
+// Vector_filter allocates its result once: by default with room for every element, trimmed after filtering,
+// define VECTOR_FILTER_COUNT_FIRST as 1 to size it exactly with a first pass counting the matches (the filter is then called twice per element)
+#ifndef VECTOR_FILTER_COUNT_FIRST
+    #define VECTOR_FILTER_COUNT_FIRST 0
+#endif // VECTOR_FILTER_COUNT_FIRST
+
+// the parallel functions (Vector_parallel_foreach/map/reduce, Vector_sort_parallel) run their work on a pool of pthreads started by the first of them,
+// define VECTOR_THREADS as 0 where pthreads are not available, they then run everything on the calling thread
+#ifndef VECTOR_THREADS
+    #if defined(__unix__) || defined(__APPLE__)
+        #define VECTOR_THREADS 1
+    #else
+        #define VECTOR_THREADS 0
+    #endif // defined(__unix__) || defined(__APPLE__)
+#endif // VECTOR_THREADS
+
+// each thread of Vector_sort_parallel sorts at least this many elements, a smaller vector is sorted on the calling thread
+#ifndef VECTOR_PARALLEL_SORT_MIN_CHUNK
+    #define VECTOR_PARALLEL_SORT_MIN_CHUNK 65536
+#endif // VECTOR_PARALLEL_SORT_MIN_CHUNK
+
+// the default grain size of Vector_parallel_foreach/map/reduce (Vector_parallel_set_grain_size): the fewest elements a thread takes at once,
+// a vector of fewer than twice this many elements is run on the calling thread
+#ifndef VECTOR_PARALLEL_GRAIN_SIZE
+    #define VECTOR_PARALLEL_GRAIN_SIZE 4096
+#endif // VECTOR_PARALLEL_GRAIN_SIZE
 
 typedef void (*Vector_free_fn)(void *vec_ptr);
+typedef void (*Vector_element_free_fn)(void *element);
 typedef size_t (*Vector_calculate_optimal_capacity_fn)(void *vec_ptr);
 
-// i am storing the element size in the header so that i can have a workaround
-// for some functions for the compilers that do not support 'typeof' keyword
-typedef struct __Vector_Header {
-    size_t element_size;
-    size_t length;
-    size_t capacity;
-    size_t initial_capacity;
-    Vector_free_fn free_fn; // Cast the pointer to the vector to the type you want and free it
-    Vector_calculate_optimal_capacity_fn calculate_optimal_capacity_fn;
-    char data[];
-} __Vector_Header;
+typedef void *(*Vector_allocator_alloc_fn)(void *context, size_t size);
+typedef void *(*Vector_allocator_realloc_fn)(void *context, void *ptr, size_t old_size, size_t new_size);
+typedef void (*Vector_allocator_free_fn)(void *context, void *ptr, size_t size);
+
+// every allocation of the library goes through one of these, the sizes are always passed so sized allocators (arenas, pools) do not have to track them
+// alloc_fn and realloc_fn return NULL on failure, realloc_fn leaves the old block untouched in that case (same contract as malloc/realloc)
+typedef struct Vector_Allocator {
+    Vector_allocator_alloc_fn alloc_fn;
+    Vector_allocator_realloc_fn realloc_fn;
+    Vector_allocator_free_fn free_fn;
+    void *context; // passed as the first argument of the functions above
+} Vector_Allocator;
+
+// the allocator backed by malloc/realloc/free, it is the default allocator unless Vector_set_default_allocator changes it
+extern const Vector_Allocator Vector_malloc_allocator;
+#if defined(__linux__)
+    // an allocator for huge vectors: every block reserves the power of two above its size (up to VECTOR_MMAP_MAX_RESERVE_SIZE) of address space,
+    // the pages are committed as they are touched, growing inside the reservation never copies (past it the mapping is moved with mremap, without copying either)
+    // the vectors derived from a vector of this allocator (filter, map, slice, ...) and the scratch buffers of its sorts use the default allocator
+    // the pages are backed by transparent huge pages when available, shrinking gives the pages past the new size back to the system
+    extern const Vector_Allocator Vector_mmap_allocator;
+#endif // defined(__linux__)
+
+// a thread local slab allocator for small vectors: each thread carves its blocks from its own slabs, so small vectors never touch malloc
+// a resize staying in the same size class (4 -> 8 -> 16 ints) keeps the block, a block freed on another thread goes back to the thread that allocated it,
+// the slabs are given back to the system by Vector_pool_release and when their thread exits
+extern const Vector_Allocator Vector_pool_allocator;
+
+#define VECTOR_ARENA_DEFAULT_CHUNK_SIZE (64 * 1024)
+
+// the size classes of Vector_pool_allocator are the powers of two from VECTOR_POOL_MIN_BLOCK_SIZE to VECTOR_POOL_MAX_BLOCK_SIZE,
+// bigger blocks (header + data) go to malloc, define VECTOR_POOL_MAX_BLOCK_SIZE (a power of two dividing VECTOR_POOL_SLAB_SIZE) the same way when compiling vector.c to change it
+#define VECTOR_POOL_MIN_BLOCK_SIZE 64
+#ifndef VECTOR_POOL_MAX_BLOCK_SIZE
+    #define VECTOR_POOL_MAX_BLOCK_SIZE 1024
+#endif // VECTOR_POOL_MAX_BLOCK_SIZE
+#define VECTOR_POOL_SLAB_SIZE (64 * 1024)
+
+// the most address space a block of Vector_mmap_allocator reserves ahead of its size (the reservation is the power of two above the size,
+// at least 2 MiB), nothing is committed until it is touched, a power of two
+#ifndef VECTOR_MMAP_MAX_RESERVE_SIZE
+    #define VECTOR_MMAP_MAX_RESERVE_SIZE ((size_t)16 << 30)
+#endif // VECTOR_MMAP_MAX_RESERVE_SIZE
+
+// a bump allocator: vectors take their memory from big chunks, and destroying the arena frees all of them at once
+// when a vector grows, its old block is given back to the arena if it was the last allocation, abandoned otherwise
+// an arena must only be used by a single thread: the bump pointer has no locking, so neither its vectors nor its scopes may be shared between threads
+// (the scopes are per thread, each thread keeps its own stack of enclosing scopes)
+typedef struct Vector_Arena {
+    Vector_Allocator allocator; // the allocator of the vectors living in the arena, its context is the arena
+    struct __Vector_Arena_Chunk *chunk; // the chunk allocations are bumped from, it links to the older chunks
+    size_t chunk_size; // the size of a new chunk (allocations bigger than that get a chunk of their own)
+} Vector_Arena;
+
+// a lazy pipeline over a vector: filter/map/skip/take stages recorded up front and run fused in a single loop over the vector
+// by a terminal operation (collect, reduce, count, any, all, foreach), no intermediate vector is built
+// the stages receive pointers to the elements, the context given with each stage is passed back to it
+#define VECTOR_PIPELINE_MAX_STAGES 8
+
+typedef bool (*Vector_pipeline_predicate_fn)(const void *element, void *context);
+typedef void (*Vector_pipeline_map_fn)(const void *element, void *result, void *context); // writes the mapped element to result
+typedef void (*Vector_pipeline_reduce_fn)(void *accumulator, const void *element, void *context); // folds the element into the accumulator
+typedef void (*Vector_pipeline_foreach_fn)(const void *element, void *context);
+
+typedef struct __Vector_Pipeline_Stage {
+    unsigned int kind; // __VECTOR_PIPELINE_* (vector.c)
+    Vector_pipeline_predicate_fn predicate_fn; // filter
+    Vector_pipeline_map_fn map_fn; // map
+    void *context;
+    size_t element_size; // the size of the elements leaving the stage
+    size_t count; // skip, take
+} __Vector_Pipeline_Stage;
+
+typedef struct Vector_Pipeline {
+    void *vec_ptr; // the source vector, read when a terminal operation runs
+    size_t stage_count;
+    __Vector_Pipeline_Stage stages[VECTOR_PIPELINE_MAX_STAGES];
+} Vector_Pipeline;
+
+// the types of the elements of Vector_sort_radix (the keys) and of the typed searches (Vector_find_eq, Vector_count_eq, Vector_count_range)
+typedef enum Vector_Scalar_Type {
+    VECTOR_SCALAR_U8,  VECTOR_SCALAR_I8,
+    VECTOR_SCALAR_U16, VECTOR_SCALAR_I16,
+    VECTOR_SCALAR_U32, VECTOR_SCALAR_I32,
+    VECTOR_SCALAR_U64, VECTOR_SCALAR_I64,
+    VECTOR_SCALAR_F32, VECTOR_SCALAR_F64  // IEEE 754, -0.0 goes before 0.0, NaNs with the sign bit first and the others last
+} Vector_Scalar_Type;
+
+// returned by Vector_find_eq when no element is found
+#define VECTOR_NPOS ((size_t)-1)
+
+typedef const void *(*Vector_radix_key_fn)(const void *element); // returns a pointer to the key of the element (usually a field of it)
+
+typedef int (*Vector_compare_fn)(const void *a, const void *b); // qsort style: negative if a goes first, positive if b goes first, 0 if they are equal
+
+// the functions of Vector_parallel_foreach/map/reduce/filter, called from several threads at once
+typedef void (*Vector_parallel_foreach_fn)(void *element, void *context);
+typedef void (*Vector_parallel_map_fn)(const void *element, void *result, void *context); // writes the mapped element to result
+typedef void (*Vector_parallel_reduce_fn)(void *accumulator, const void *element, void *context); // folds the element into the accumulator
+typedef void (*Vector_parallel_combine_fn)(void *accumulator, const void *partial, void *context); // folds a partial accumulator into the accumulator
+typedef bool (*Vector_parallel_predicate_fn)(const void *element, void *context);
+
+// the data is aligned for any fundamental type no matter which fields the header holds
+#if LANGUAGE_CPP
+    #define __VECTOR_MAX_ALIGNED alignas(max_align_t)
+#else // LANGUAGE_CPP
+    #define __VECTOR_MAX_ALIGNED _Alignas(max_align_t)
+#endif // LANGUAGE_CPP
+
+#if VECTOR_COMPACT_HEADER
+    // the configuration of a vector, interned: the vectors configured the same way point to the same record, which is freed with the last of them
+    typedef struct __Vector_Traits {
+        size_t element_size;
+        size_t initial_capacity;
+        Vector_free_fn free_fn; // Cast the pointer to the vector to the type you want and free it
+        Vector_element_free_fn element_free_fn; // releases what a single element owns, called on the elements the vector drops
+        Vector_calculate_optimal_capacity_fn calculate_optimal_capacity_fn;
+        const Vector_Allocator *allocator; // the header and the data live in a single block from this allocator
+        size_t alignment; // the alignment of data, alignof(max_align_t) unless the vector was initialized with Vector_init_aligned
+    } __Vector_Traits;
+
+    typedef struct __Vector_Header {
+        uint32_t length;
+        uint32_t capacity;
+        uint32_t reserved_capacity; // the capacity will not shrink below this until the reservation is released (Vector_shrink_to_fit)
+        uint16_t flags; // __VECTOR_FLAG_* bits
+        uint16_t header_offset; // the number of padding bytes between the start of the block and the header, so that data is aligned
+        const __Vector_Traits *traits;
+        __VECTOR_MAX_ALIGNED char data[];
+    } __Vector_Header;
+
+    // reads a field of the configuration of a vector, wherever the header mode keeps it
+    #define __VECTOR_TRAIT(__header__, __field__) ((__header__)->traits->__field__)
+    #define __VECTOR_MAX_CAPACITY ((size_t)UINT32_MAX)
+#else // VECTOR_COMPACT_HEADER
+    // i am storing the element size in the header so that i can have a workaround
+    // for some functions for the compilers that do not support 'typeof' keyword
+    typedef struct __Vector_Header {
+        size_t element_size;
+        size_t length;
+        size_t capacity;
+        size_t initial_capacity;
+        size_t reserved_capacity; // the capacity will not shrink below this until the reservation is released (Vector_shrink_to_fit)
+        Vector_free_fn free_fn; // Cast the pointer to the vector to the type you want and free it
+        Vector_element_free_fn element_free_fn; // releases what a single element owns, called on the elements the vector drops
+        Vector_calculate_optimal_capacity_fn calculate_optimal_capacity_fn;
+        const Vector_Allocator *allocator; // the header and the data live in a single block from this allocator
+        uint16_t flags; // __VECTOR_FLAG_* bits
+        uint16_t header_offset; // the number of padding bytes between the start of the block and the header, so that data is aligned
+        uint32_t alignment; // the alignment of data, alignof(max_align_t) unless the vector was initialized with Vector_init_aligned
+        __VECTOR_MAX_ALIGNED char data[];
+    } __Vector_Header;
+
+    // reads a field of the configuration of a vector, wherever the header mode keeps it
+    #define __VECTOR_TRAIT(__header__, __field__) ((__header__)->__field__)
+    #define __VECTOR_MAX_CAPACITY ((size_t)SIZE_MAX)
+#endif // VECTOR_COMPACT_HEADER
+
+// the block is storage provided by the caller (Vector_init_inline): it is never given to the allocator, growing past it moves the vector to the heap
+#define __VECTOR_FLAG_INLINE 1u
 
 
 #if !COMPILER_SUPPORTS_STATEMENT_EXPRESSIONS
@@ -66,6 +253,41 @@ __Vector_Header *__vector_get_header(void *vec_ptr);
  */
 void __vector_resize_if_needed(void *vec_ptr);
 
+/**
+ * Internal
+ * 
+ * Resizes the vector through its optimal capacity function before an insertion, called by the insertion macros when the vector is full
+ * or when it has a custom optimal capacity function (which is consulted on every change)
+ * Kept out of line so the common case of the insertion macros (default policy, room left) stays a single inline check
+ * @param vec_ptr [T**]    - A reference to the vector
+ * @throw         [assert] - If the reference to the vector is NULL
+ * @throw         [assert] - If the vector is NULL
+ * @throw         [assert] - If the optimal capacity leaves no room for a new element
+ * @throw         [assert] - If realloc fails
+ */
+void __vector_grow(void *vec_ptr);
+
+/**
+ * Internal
+ * 
+ * Makes room for `count` more elements with at most one reallocation, the capacity grows geometrically so repeated bulk appends stay amortized O(1)
+ * @param vec_ptr [T**]    - A reference to the vector
+ * @param count   [size_t] - The number of elements about to be appended
+ * @throw         [assert] - If the reference to the vector is NULL
+ * @throw         [assert] - If the vector is NULL
+ * @throw         [assert] - If realloc fails
+ */
+void __vector_reserve_more(void *vec_ptr, size_t count);
+
+/**
+ * Internal
+ * 
+ * Returns the header of a vector without checking it, for the hot paths of the macros that already asserted the vector is not NULL
+ * @param __vec__ [T*]               - The vector
+ * @return        [__Vector_Header*] - The header of the vector
+ */
+#define __vector_header__(__vec__) ((__Vector_Header *)((char *)(__vec__) - sizeof(__Vector_Header)))
+
 /**
  * Internal
  * 
@@ -76,6 +298,96 @@ void __vector_resize_if_needed(void *vec_ptr);
  */
 void *__vector_init(size_t element_size);
 
+/**
+ * Internal
+ * 
+ * Initializes a vector with room for `capacity` elements in a single allocation, the capacity is reserved
+ * @param element_size [size_t] - The size of the vector type
+ * @param capacity     [size_t] - The capacity to allocate and reserve
+ * @return             [T*]     - The array of data
+ * @throw              [assert] - If malloc fails
+ */
+void *__vector_init_with_capacity(size_t element_size, size_t capacity);
+
+/**
+ * Internal
+ * 
+ * Initializes a vector whose memory comes from the given allocator
+ * @param element_size [size_t]            - The size of the vector type
+ * @param allocator    [Vector_Allocator*] - The allocator of the vector, NULL for the default allocator
+ * @return             [T*]                - The array of data
+ * @throw              [assert]            - If the allocation fails
+ */
+void *__vector_init_with_allocator(size_t element_size, const Vector_Allocator *allocator);
+
+/**
+ * Internal
+ * 
+ * Initializes a vector whose data is aligned to `alignment` bytes
+ * @param element_size [size_t] - The size of the vector type
+ * @param alignment    [size_t] - The alignment of the data, a power of two
+ * @return             [T*]     - The array of data
+ * @throw              [assert] - If the alignment is not a power of two, if the allocation fails
+ */
+void *__vector_init_aligned(size_t element_size, size_t alignment);
+
+/**
+ * Internal
+ * 
+ * Initializes a vector that inherits the allocator (Vector_mmap_allocator excepted, see __vector_derived_allocator) and the alignment of another vector, used for the vectors derived from a vector (map, filter, slice)
+ * @param src_vec_ptr  [T**]     - A reference to the vector to inherit from
+ * @param element_size [size_t]  - The size of the new vector type
+ * @param capacity     [size_t]  - The capacity of the new vector
+ * @return             [U*]      - The array of data
+ * @throw              [assert]  - If the reference to the source vector is NULL
+ * @throw              [assert]  - If the source vector is NULL
+ * @throw              [assert]  - If the allocation fails
+ */
+void *__vector_init_from(void *src_vec_ptr, size_t element_size, size_t capacity);
+
+/**
+ * Internal
+ * 
+ * Initializes a vector living in storage provided by the caller
+ * @param element_size [size_t]  - The size of the vector type
+ * @param storage      [void*]   - The storage of the header and the elements, aligned like __Vector_Header
+ * @param storage_size [size_t]  - The size of the storage in bytes
+ * @return             [T*]      - The array of data
+ * @throw              [assert]  - If the storage is NULL, if it has no room for the header and one element
+ */
+void *__vector_init_inline(size_t element_size, void *storage, size_t storage_size);
+
+/**
+ * Internal
+ * 
+ * Allocates memory through an allocator
+ * @param allocator [Vector_Allocator*] - The allocator
+ * @param size      [size_t]            - The number of bytes to allocate
+ * @return          [void*]             - The allocated memory
+ * @throw           [assert]            - If the allocation fails
+ */
+void *__vector_allocator_alloc(const Vector_Allocator *allocator, size_t size);
+
+/**
+ * Internal
+ * 
+ * Frees memory allocated through an allocator
+ * @param allocator [Vector_Allocator*] - The allocator
+ * @param ptr       [void*]             - The memory to free
+ * @param size      [size_t]            - The number of bytes that were allocated
+ */
+void __vector_allocator_free(const Vector_Allocator *allocator, void *ptr, size_t size);
+
+/**
+ * Internal
+ * 
+ * Returns the allocator of the vectors derived from a vector and of the scratch buffers working on it:
+ * the allocator of the vector, except Vector_mmap_allocator which is replaced by the default allocator (malloc if that is Vector_mmap_allocator too)
+ * @param allocator [Vector_Allocator*] - The allocator of the vector
+ * @return          [Vector_Allocator*] - The allocator to use
+ */
+const Vector_Allocator *__vector_derived_allocator(const Vector_Allocator *allocator);
+
 /**
  * Public
  * 
@@ -83,119 +395,814 @@ void *__vector_init(size_t element_size);
  * @param __T__ [type] - The type of the vector elements
  * @return      [T*]   - The vector
  */
-#define Vector_init(__T__) (__T__*)__vector_init(sizeof(__T__))
-
+#define Vector_init(__T__) (__T__*)__vector_init(sizeof(__T__))
+
+/**
+ * Public
+ * 
+ * Initializes a vector whose memory comes from the given allocator instead of the default one
+ * @param __T__         [type]              - The type of the vector elements
+ * @param __allocator__ [Vector_Allocator*] - The allocator of the vector (must outlive the vector), NULL for the default allocator
+ * @return              [T*]                - The vector
+ * @throw               [assert]            - If the allocation fails
+ */
+#define Vector_init_with_allocator(__T__, __allocator__) (__T__*)__vector_init_with_allocator(sizeof(__T__), (__allocator__))
+
+/**
+ * Public
+ * 
+ * Initializes a vector whose data (the first element) is aligned to `__alignment__` bytes, 64 for cache lines, 32 or 64 for AVX
+ * The alignment survives the resizes, and the vectors derived from it (copy, map, filter, slice) are aligned the same way
+ * @param __T__         [type]   - The type of the vector elements
+ * @param __alignment__ [size_t] - The alignment of the data, a power of two (anything below alignof(max_align_t) is rounded up to it)
+ * @return              [T*]     - The vector
+ * @throw               [assert] - If the alignment is not a power of two, if the allocation fails
+ */
+#define Vector_init_aligned(__T__, __alignment__) (__T__*)__vector_init_aligned(sizeof(__T__), (__alignment__))
+
+/**
+ * Public
+ * 
+ * The type of a storage holding a vector header and `__n__` elements, to declare on the stack or inside a struct for Vector_init_inline
+ * @param __T__ [type]   - The type of the vector elements
+ * @param __n__ [size_t] - The number of elements the storage has room for
+ */
+#define Vector_inline_storage(__T__, __n__) union { __Vector_Header __header__; char __bytes__[sizeof(__Vector_Header) + sizeof(__T__) * (__n__)]; }
+
+/**
+ * Public
+ * 
+ * Initializes a vector in caller provided storage, no allocation happens until the vector outgrows it (it then moves to the default allocator)
+ * The storage must outlive the vector, Vector_destroy never frees it
+ * @param __T__           [type]                   - The type of the vector elements
+ * @param __storage_ptr__ [Vector_inline_storage*] - A pointer to the storage
+ * @return                [T*]                     - The vector
+ * @throw                 [assert]                 - If the storage is NULL, if it has no room for one element
+ */
+#define Vector_init_inline(__T__, __storage_ptr__) (__T__*)__vector_init_inline(sizeof(__T__), (__storage_ptr__), sizeof(*(__storage_ptr__)))
+
+/**
+ * Public
+ * 
+ * Initializes a vector with room for `__capacity__` elements in a single allocation
+ * The capacity is reserved: automatic shrinking will not go below it until Vector_shrink_to_fit releases it
+ * @param __T__        [type]   - The type of the vector elements
+ * @param __capacity__ [size_t] - The number of elements to make room for
+ * @return             [T*]     - The vector
+ * @throw              [assert] - If malloc fails
+ */
+#define Vector_init_with_capacity(__T__, __capacity__) (__T__*)__vector_init_with_capacity(sizeof(__T__), (__capacity__))
+
+
+/**
+ * Public
+ * 
+ * Gets the size of an element in the vector
+ * @param vec_ptr [T**]    - A reference to the vector
+ * @return        [size_t] - The element size of the vector
+ * @throw         [assert] - If the reference to the vector is NULL
+ * @throw         [assert] - If the vector is NULL
+ */
+size_t Vector_get_element_size(void *vec_ptr);
+
+/**
+ * Public
+ * 
+ * Returns the number of elements in a vector
+ * @param vec_ptr [T**]    - A reference to the vector
+ * @return        [size_t] - The number of elements in the vector
+ * @throw         [assert] - If the reference to the vector is NULL
+ * @throw         [assert] - If the vector is NULL
+ */
+size_t Vector_get_length(void *vec_ptr);
+
+/**
+ * Public
+ * 
+ * Returns the capacity of a vector
+ * @param vec_ptr [T**]    - A reference to the vector
+ * @return        [size_t] - The capacity of the vector
+ * @throw         [assert] - If the reference to the vector is NULL
+ * @throw         [assert] - If the vector is NULL
+ */
+size_t Vector_get_capacity(void *vec_ptr);
+
+/**
+ * Public
+ * 
+ * Returns the initial capacity of a vector
+ * @param vec_ptr [T**]    - A reference to the vector
+ * @return        [size_t] - The initial capacity of the vector
+ * @throw         [assert] - If the reference to the vector is NULL
+ * @throw         [assert] - If the vector is NULL
+ */
+size_t Vector_get_initial_capacity(void *vec_ptr);
+
+/**
+ * Public
+ * 
+ * Returns the reserved capacity of a vector, the capacity automatic shrinking will not go below (0 if nothing is reserved)
+ * @param vec_ptr [T**]    - A reference to the vector
+ * @return        [size_t] - The reserved capacity of the vector
+ * @throw         [assert] - If the reference to the vector is NULL
+ * @throw         [assert] - If the vector is NULL
+ */
+size_t Vector_get_reserved_capacity(void *vec_ptr);
+
+/**
+ * Public
+ * 
+ * Returns the alignment of the data of a vector
+ * @param vec_ptr [T**]    - A reference to the vector
+ * @return        [size_t] - The alignment of the vector data in bytes
+ * @throw         [assert] - If the reference to the vector is NULL
+ * @throw         [assert] - If the vector is NULL
+ */
+size_t Vector_get_alignment(void *vec_ptr);
+
+/**
+ * Public
+ * 
+ * Checks if the vector is full
+ * @param vec_ptr [T**]    - A reference to the vector
+ * @return        [bool]   - True if the vector is full, false otherwise
+ * @throw         [assert] - If the reference to the vector is NULL
+ * @throw         [assert] - If the vector is NULL
+ */
+bool Vector_is_full(void *vec_ptr);
+
+/**
+ * Public
+ * 
+ * Returns true if the capacity is less than half full (there is a lot of unused space) and capacity > initial_capacity (the initial_capacity is the minimum capacity)
+ * @param vec_ptr [T**]    - A reference to the vector
+ * @return        [bool]   - True if the vector is underfilled, false otherwise
+ * @throw         [assert] - If the reference to the vector is NULL
+ * @throw         [assert] - If the vector is NULL
+ */
+bool Vector_is_underfilled(void *vec_ptr);
+
+/**
+ * Public
+ * 
+ * Checks if the vector is empty
+ * @param vec_ptr [T**]    - A reference to the vector
+ * @return        [bool]   - True if the vector is empty, false otherwise
+ * @throw         [assert] - If the reference to the vector is NULL
+ * @throw         [assert] - If the vector is NULL
+ */
+bool Vector_is_empty(void *vec_ptr);
+
+/**
+ * Public
+ * 
+ * Checks if the vector still lives in the storage given to Vector_init_inline
+ * @param vec_ptr [T**]    - A reference to the vector
+ * @return        [bool]   - True if the vector is inline, false if it is on the heap
+ * @throw         [assert] - If the reference to the vector is NULL
+ * @throw         [assert] - If the vector is NULL
+ */
+bool Vector_is_inline(void *vec_ptr);
+
+/**
+ * Public
+ * 
+ * Sets the custom free function of the vector
+ * @param vec_ptr [T**]            - a reference to the vector
+ * @param free_fn [Vector_free_fn] - the free function to free the vector
+ * @throw         [assert]         - if the reference to the vector is NULL
+ * @throw         [assert]         - if the vector is NULL
+ */
+void Vector_set_free_fn(void *vec_ptr, Vector_free_fn free_fn);
+
+/**
+ * Public
+ * 
+ * Sets the function releasing what a single element owns, the vector calls it on every element it drops:
+ * Vector_clear, Vector_destroy (without a custom free function), Vector_retain, Vector_remove_if, Vector_swap_remove_indices and Vector_remove_range without an out buffer
+ * The elements handed back to the caller (pop, remove_at, ...) are not released
+ * @param vec_ptr         [T**]                    - A reference to the vector
+ * @param element_free_fn [Vector_element_free_fn] - The function receiving a pointer to the element to release, NULL for none
+ * @throw                 [assert]                 - If the reference to the vector is NULL
+ * @throw                 [assert]                 - If the vector is NULL
+ */
+void Vector_set_element_free_fn(void *vec_ptr, Vector_element_free_fn element_free_fn);
+
+/**
+ * Internal
+ * 
+ * Calls the element free function of the vector, if it has one, on `count` elements starting at `index`
+ * @param vec_ptr [T**]    - A reference to the vector
+ * @param index   [size_t] - The index of the first element to release
+ * @param count   [size_t] - The number of elements to release
+ */
+void __vector_free_elements(void *vec_ptr, size_t index, size_t count);
+
+/**
+ * Public
+ * 
+ * Sets the custom initial capacity of the vector and resizes it immediately
+ * The default initial capacity is 4
+ * @param vec_ptr          [T**]    - A reference to the vector
+ * @param initial_capacity [size_t] - The initial capacity of the vector
+ * @throw                  [assert] - If the reference to the vector is NULL
+ * @throw                  [assert] - If the vector is NULL
+ */
+void Vector_set_initial_capacity(void *vec_ptr, size_t initial_capacity);
+
+/**
+ * Public
+ * 
+ * Makes sure the vector has room for at least `capacity` elements, growing it at most once (to exactly `capacity`)
+ * The capacity is reserved: automatic shrinking will not go below it until Vector_shrink_to_fit releases it,
+ * unlike Vector_set_initial_capacity this does not change the minimum the optimal capacity calculation works with
+ * @param vec_ptr  [T**]    - A reference to the vector
+ * @param capacity [size_t] - The number of elements to make room for
+ * @throw          [assert] - If the reference to the vector is NULL
+ * @throw          [assert] - If the vector is NULL
+ * @throw          [assert] - If realloc fails
+ */
+void Vector_reserve(void *vec_ptr, size_t capacity);
+
+/**
+ * Public
+ * 
+ * Appends `count` elements copied from an array, growing the vector at most once and copying them with a single memcpy
+ * The array may point into the vector itself
+ * @param vec_ptr [T**]     - A reference to the vector
+ * @param array   [const T*] - The elements to append
+ * @param count   [size_t]   - The number of elements to append
+ * @throw         [assert]   - If the reference to the vector is NULL
+ * @throw         [assert]   - If the vector is NULL
+ * @throw         [assert]   - If the array is NULL while count is not 0
+ * @throw         [assert]   - If realloc fails
+ */
+void Vector_extend_from_array(void *vec_ptr, const void *array, size_t count);
+
+/**
+ * Public
+ * 
+ * Inserts `count` elements copied from an array at `index`, shifting the tail once and growing the vector at most once
+ * The array may point into the vector itself
+ * @param vec_ptr [T**]     - A reference to the vector
+ * @param index   [size_t]   - The index to insert the elements at, the length of the vector to append them
+ * @param array   [const T*] - The elements to insert
+ * @param count   [size_t]   - The number of elements to insert
+ * @throw         [assert]   - If the reference to the vector is NULL
+ * @throw         [assert]   - If the vector is NULL
+ * @throw         [assert]   - If the index is out of bounds
+ * @throw         [assert]   - If the array is NULL while count is not 0
+ * @throw         [assert]   - If realloc fails
+ */
+void Vector_insert_range(void *vec_ptr, size_t index, const void *array, size_t count);
+
+/**
+ * Public
+ * 
+ * Removes `count` contiguous elements starting at `index`, shifting the tail once and shrinking the vector at most once
+ * @param vec_ptr [T**]    - A reference to the vector
+ * @param index   [size_t] - The index of the first element to remove
+ * @param count   [size_t] - The number of elements to remove
+ * @param out     [T*]     - A buffer of at least `count` elements receiving the removed elements, if NULL, they are released with the element free function
+ * @throw         [assert] - If the reference to the vector is NULL
+ * @throw         [assert] - If the vector is NULL
+ * @throw         [assert] - If the range is out of bounds
+ * @throw         [assert] - If realloc fails
+ */
+void Vector_remove_range(void *vec_ptr, size_t index, size_t count, void *out);
+
+/**
+ * Public
+ * 
+ * Removes the elements at the given indices in a single pass, each one is replaced by the last element, so the order is not preserved
+ * The indices all refer to the vector before the call, none of them is invalidated by the removal of another
+ * The removed elements are released with the element free function and the capacity is shrunk at most once
+ * @param vec_ptr [T**]     - A reference to the vector
+ * @param indices [size_t*] - The indices to remove, sorted in place (descending) by the call
+ * @param count   [size_t]  - The number of indices
+ * @throw         [assert]  - If the reference to the vector is NULL
+ * @throw         [assert]  - If the vector is NULL
+ * @throw         [assert]  - If the indices are NULL while count is not 0
+ * @throw         [assert]  - If an index is out of bounds or appears twice
+ */
+void Vector_swap_remove_indices(void *vec_ptr, size_t *indices, size_t count);
+
+/**
+ * Public
+ * 
+ * Releases the reserved capacity and shrinks the capacity to exactly the length of the vector
+ * @param vec_ptr [T**]    - A reference to the vector
+ * @throw         [assert] - If the reference to the vector is NULL
+ * @throw         [assert] - If the vector is NULL
+ * @throw         [assert] - If realloc fails
+ */
+void Vector_shrink_to_fit(void *vec_ptr);
+
+/**
+ * Public
+ * 
+ * Sets the custom function that calculates the optimal capacity of the vector
+ * It is called before every insertion (and must then leave room for one more element) and after every removal
+ * @param vec_ptr                       [T**]                                  - A reference to the vector
+ * @param calculate_optimal_capacity_fn [Vector_calculate_optimal_capacity_fn] - The function that calculates the optimal capacity of the vector
+ * @throw                               [assert]                               - If the reference to the vector is NULL
+ * @throw                               [assert]                               - If the vector is NULL
+ */
+void Vector_set_calculate_optimal_capacity_fn(void *vec_ptr, Vector_calculate_optimal_capacity_fn calculate_optimal_capacity_fn);
+
+/**
+ * Public
+ * 
+ * Calculates a capacity with separate grow and shrink thresholds (hysteresis)
+ * The vector grows by `growth_factor` only when it is full, and shrinks only when it is less than 1/`shrink_divisor` full,
+ * so a vector whose length oscillates around a boundary does not reallocate on every push/pop
+ * Use it from your own Vector_calculate_optimal_capacity_fn to pick a different growth factor or shrink threshold,
+ * `shrink_divisor` should be greater than `growth_factor`, otherwise a shrink can land right on the next growth boundary
+ * @param vec_ptr        [T**]    - A reference to the vector
+ * @param growth_factor  [double] - The factor the capacity is multiplied by when the vector is full (> 1)
+ * @param shrink_divisor [size_t] - The vector shrinks when length * shrink_divisor < capacity (>= 2)
+ * @return               [size_t] - The optimal capacity for the vector
+ * @throw                [assert] - If the reference to the vector is NULL
+ * @throw                [assert] - If the vector is NULL
+ * @throw                [assert] - If the growth factor is not greater than 1 or the shrink divisor is less than 2
+ */
+size_t Vector_calculate_hysteresis_capacity(void *vec_ptr, double growth_factor, size_t shrink_divisor);
+
+/**
+ * Public
+ * 
+ * Built-in Vector_calculate_optimal_capacity_fn with hysteresis: grows by VECTOR_DEFAULT_GROWTH_FACTOR when full,
+ * shrinks only when the vector is less than 1/VECTOR_DEFAULT_SHRINK_DIVISOR full
+ * Select it per vector with `Vector_set_calculate_optimal_capacity_fn(&vec, Vector_calculate_hysteresis_optimal_capacity)`
+ * @param vec_ptr [T**]    - A reference to the vector
+ * @return        [size_t] - The optimal capacity for the vector
+ * @throw         [assert] - If the reference to the vector is NULL
+ * @throw         [assert] - If the vector is NULL
+ */
+size_t Vector_calculate_hysteresis_optimal_capacity(void *vec_ptr);
+
+/**
+ * Public
+ * 
+ * Sets the allocator used by the vectors initialized from now on (the vectors derived from another vector inherit the allocator of their source instead, except Vector_mmap_allocator)
+ * @param allocator [Vector_Allocator*] - The allocator (must outlive the vectors using it), NULL to go back to Vector_malloc_allocator
+ */
+void Vector_set_default_allocator(const Vector_Allocator *allocator);
+
+/**
+ * Public
+ * 
+ * Returns the allocator used by the vectors initialized from now on (the one of the current arena scope if there is one)
+ * @return [Vector_Allocator*] - The default allocator
+ */
+const Vector_Allocator *Vector_get_default_allocator(void);
+
+/**
+ * Public
+ * 
+ * Initializes an arena, no memory is allocated until the first vector is
+ * @param arena      [Vector_Arena*] - The arena to initialize
+ * @param chunk_size [size_t]        - The size of the chunks the arena allocates, 0 for VECTOR_ARENA_DEFAULT_CHUNK_SIZE
+ * @throw            [assert]        - If the arena is NULL
+ */
+void Vector_arena_init(Vector_Arena *arena, size_t chunk_size);
+
+/**
+ * Public
+ * 
+ * Frees all the memory of the arena at once, the vectors allocated from it must not be used anymore (there is no need to destroy them)
+ * @param arena [Vector_Arena*] - The arena to destroy
+ * @throw       [assert]        - If the arena is NULL
+ */
+void Vector_arena_destroy(Vector_Arena *arena);
+
+/**
+ * Public
+ * 
+ * Releases every allocation of the arena but keeps its first chunk for reuse (for example between two requests), the vectors allocated from it must not be used anymore
+ * @param arena [Vector_Arena*] - The arena to reset
+ * @throw       [assert]        - If the arena is NULL
+ */
+void Vector_arena_reset(Vector_Arena *arena);
+
+/**
+ * Public
+ * 
+ * Returns the allocator of an arena, to use it for a single vector (Vector_init_with_allocator, Vector_set_allocator)
+ * @param arena [Vector_Arena*]     - The arena
+ * @return      [Vector_Allocator*] - The allocator of the arena
+ * @throw       [assert]            - If the arena is NULL
+ */
+const Vector_Allocator *Vector_arena_get_allocator(Vector_Arena *arena);
+
+/**
+ * Public
+ * 
+ * Starts an arena scope on the calling thread: the vectors initialized until Vector_arena_end_scope take their memory from the arena
+ * Scopes can be nested (up to 64 deep on a thread), the vectors derived from a vector (copy, map, filter, slice) keep using the allocator of their source
+ * @param arena [Vector_Arena*] - The arena, used by the calling thread only
+ * @throw       [assert]        - If the arena is NULL
+ * @throw       [assert]        - If the calling thread already has 64 nested scopes
+ */
+void Vector_arena_begin_scope(Vector_Arena *arena);
+
+/**
+ * Public
+ * 
+ * Ends the arena scope started by Vector_arena_begin_scope, the allocator of the enclosing scope (or the default allocator) is used again
+ * @param arena [Vector_Arena*] - The arena
+ * @throw       [assert]        - If the arena is NULL
+ * @throw       [assert]        - If the arena is not the innermost scope of the calling thread
+ */
+void Vector_arena_end_scope(Vector_Arena *arena);
+
+/**
+ * Public
+ * 
+ * Returns the number of times Vector_pool_allocator called malloc/realloc (slabs and blocks bigger than VECTOR_POOL_MAX_BLOCK_SIZE), all threads included
+ * @return [size_t] - The number of system allocations of the pool
+ */
+size_t Vector_pool_get_malloc_count(void);
+
+/**
+ * Public
+ * 
+ * Gives the slabs of the calling thread holding no live block back to the system, blocks freed by other threads included
+ */
+void Vector_pool_release(void);
+
+/**
+ * Public
+ * 
+ * Returns the allocator of a vector
+ * @param vec_ptr [T**]               - A reference to the vector
+ * @return        [Vector_Allocator*] - The allocator of the vector
+ * @throw         [assert]            - If the reference to the vector is NULL
+ * @throw         [assert]            - If the vector is NULL
+ */
+const Vector_Allocator *Vector_get_allocator(void *vec_ptr);
+
+/**
+ * Public
+ * 
+ * Moves the vector into memory from another allocator (one allocation from the new allocator, one free to the old one)
+ * An inline vector stays in its storage, the allocator is the one it moves to when it outgrows it
+ * @param vec_ptr   [T**]               - A reference to the vector
+ * @param allocator [Vector_Allocator*] - The new allocator (must outlive the vector), NULL for the default allocator
+ * @throw           [assert]            - If the reference to the vector is NULL
+ * @throw           [assert]            - If the vector is NULL
+ * @throw           [assert]            - If the allocation fails
+ */
+void Vector_set_allocator(void *vec_ptr, const Vector_Allocator *allocator);
+
+/**
+ * Public
+ * 
+ * Releases the memory of the vector through its allocator and sets it to NULL, without calling its free function (inline storage is left alone)
+ * Meant to be called by a custom Vector_free_fn once it is done with the elements
+ * @param vec_ptr [T**]    - A reference to the vector
+ * @throw         [assert] - If the reference to the vector is NULL
+ * @throw         [assert] - If the vector is NULL
+ */
+void Vector_deallocate(void *vec_ptr);
+
+/**
+ * Public
+ * 
+ * Returns the number of capacity changes done by all the vectors since the program started
+ * @return [size_t] - The number of resizes
+ */
+size_t Vector_get_resize_count(void);
+
+/**
+ * Public
+ * 
+ * Returns the number of capacity changes that kept the vector in place (the allocator extended or shrank the block, so the data was not copied)
+ * @return [size_t] - The number of resizes that avoided a copy
+ */
+size_t Vector_get_inplace_resize_count(void);
+
+/**
+ * Public
+ * 
+ * Initializes a pipeline over a vector, without any stage, nothing runs until a terminal operation
+ * @param pipeline [Vector_Pipeline*] - The pipeline to initialize
+ * @param vec_ptr  [T**]              - A reference to the source vector, it must outlive the pipeline
+ * @throw          [assert]           - If the pipeline is NULL
+ * @throw          [assert]           - If the reference to the vector is NULL
+ * @throw          [assert]           - If the vector is NULL
+ */
+void Vector_pipeline_init(Vector_Pipeline *pipeline, void *vec_ptr);
+
+/**
+ * Public
+ * 
+ * Adds a stage letting through the elements for which the predicate returns true
+ * @param pipeline     [Vector_Pipeline*]             - The pipeline
+ * @param predicate_fn [Vector_pipeline_predicate_fn] - The predicate
+ * @param context      [void*]                        - Passed to the predicate
+ * @throw              [assert]                       - If the pipeline is NULL, if it has VECTOR_PIPELINE_MAX_STAGES stages already
+ */
+void Vector_pipeline_filter(Vector_Pipeline *pipeline, Vector_pipeline_predicate_fn predicate_fn, void *context);
+
+/**
+ * Public
+ * 
+ * Adds a stage mapping every element to an element of `element_size` bytes
+ * @param pipeline     [Vector_Pipeline*]       - The pipeline
+ * @param map_fn       [Vector_pipeline_map_fn] - The mapper, it writes the mapped element to its result argument
+ * @param element_size [size_t]                 - The size of the mapped elements
+ * @param context      [void*]                  - Passed to the mapper
+ * @throw              [assert]                 - If the pipeline is NULL, if it has VECTOR_PIPELINE_MAX_STAGES stages already
+ */
+void Vector_pipeline_map(Vector_Pipeline *pipeline, Vector_pipeline_map_fn map_fn, size_t element_size, void *context);
+
+/**
+ * Public
+ * 
+ * Adds a stage dropping the first `count` elements reaching it
+ * @param pipeline [Vector_Pipeline*] - The pipeline
+ * @param count    [size_t]           - The number of elements to skip
+ * @throw          [assert]           - If the pipeline is NULL, if it has VECTOR_PIPELINE_MAX_STAGES stages already
+ */
+void Vector_pipeline_skip(Vector_Pipeline *pipeline, size_t count);
+
+/**
+ * Public
+ * 
+ * Adds a stage letting through the first `count` elements reaching it, the pipeline stops reading the vector after them
+ * @param pipeline [Vector_Pipeline*] - The pipeline
+ * @param count    [size_t]           - The number of elements to take
+ * @throw          [assert]           - If the pipeline is NULL, if it has VECTOR_PIPELINE_MAX_STAGES stages already
+ */
+void Vector_pipeline_take(Vector_Pipeline *pipeline, size_t count);
+
+/**
+ * Public
+ * 
+ * Runs the pipeline and collects its output in a new vector, allocated once from the allocator of the source vector and trimmed to its length
+ * @param pipeline [Vector_Pipeline*] - The pipeline
+ * @return         [U*]               - The new vector, of the element type of the last map stage (of the source vector without one)
+ * @throw          [assert]           - If the pipeline is NULL
+ * @throw          [assert]           - If the allocation fails
+ */
+void *Vector_pipeline_collect(const Vector_Pipeline *pipeline);
+
+/**
+ * Public
+ * 
+ * Runs the pipeline and folds its output into an accumulator
+ * @param pipeline    [Vector_Pipeline*]          - The pipeline
+ * @param reduce_fn   [Vector_pipeline_reduce_fn] - The reducer, called with the accumulator and each element
+ * @param accumulator [void*]                     - The accumulator, holding the initial value
+ * @param context     [void*]                     - Passed to the reducer
+ * @throw             [assert]                    - If the pipeline is NULL
+ */
+void Vector_pipeline_reduce(const Vector_Pipeline *pipeline, Vector_pipeline_reduce_fn reduce_fn, void *accumulator, void *context);
+
+/**
+ * Public
+ * 
+ * Runs the pipeline and counts its output
+ * @param pipeline [Vector_Pipeline*] - The pipeline
+ * @return         [size_t]           - The number of elements leaving the pipeline
+ * @throw          [assert]           - If the pipeline is NULL
+ */
+size_t Vector_pipeline_count(const Vector_Pipeline *pipeline);
+
+/**
+ * Public
+ * 
+ * Runs the pipeline until an element satisfies the predicate
+ * @param pipeline     [Vector_Pipeline*]             - The pipeline
+ * @param predicate_fn [Vector_pipeline_predicate_fn] - The predicate
+ * @param context      [void*]                        - Passed to the predicate
+ * @return             [bool]                         - True if an element satisfies the predicate
+ * @throw              [assert]                       - If the pipeline is NULL
+ */
+bool Vector_pipeline_any(const Vector_Pipeline *pipeline, Vector_pipeline_predicate_fn predicate_fn, void *context);
+
+/**
+ * Public
+ * 
+ * Runs the pipeline until an element does not satisfy the predicate
+ * @param pipeline     [Vector_Pipeline*]             - The pipeline
+ * @param predicate_fn [Vector_pipeline_predicate_fn] - The predicate
+ * @param context      [void*]                        - Passed to the predicate
+ * @return             [bool]                         - True if every element satisfies the predicate (true for an empty output)
+ * @throw              [assert]                       - If the pipeline is NULL
+ */
+bool Vector_pipeline_all(const Vector_Pipeline *pipeline, Vector_pipeline_predicate_fn predicate_fn, void *context);
+
+/**
+ * Public
+ * 
+ * Runs the pipeline and calls a function on each element of its output
+ * @param pipeline   [Vector_Pipeline*]           - The pipeline
+ * @param foreach_fn [Vector_pipeline_foreach_fn] - The function
+ * @param context    [void*]                      - Passed to the function
+ * @throw            [assert]                     - If the pipeline is NULL
+ */
+void Vector_pipeline_foreach(const Vector_Pipeline *pipeline, Vector_pipeline_foreach_fn foreach_fn, void *context);
+
+/**
+ * Public
+ * 
+ * Sorts a vector of integers or floats in place with an LSD radix sort, stable and without comparisons,
+ * one pass per byte of the key, the passes where every key has the same byte are skipped
+ * Allocates a single scratch buffer of the size of the vector from its allocator
+ * @param vec_ptr  [T**]                - A reference to the vector
+ * @param key_type [Vector_Scalar_Type] - The type of the elements
+ * @throw          [assert]             - If the reference to the vector is NULL
+ * @throw          [assert]             - If the vector is NULL
+ * @throw          [assert]             - If the element size is not the size of the key type
+ */
+void Vector_sort_radix(void *vec_ptr, Vector_Scalar_Type key_type);
+
+/**
+ * Public
+ * 
+ * Sorts a vector in place by a key of its elements with an LSD radix sort (see Vector_sort_radix), the elements with equal keys keep their order
+ * @param vec_ptr  [T**]                 - A reference to the vector
+ * @param key_type [Vector_Scalar_Type]  - The type of the key
+ * @param key_fn   [Vector_radix_key_fn] - Returns a pointer to the key of an element, called on every element by the histogram scan and by each pass
+ * @throw          [assert]              - If the reference to the vector is NULL
+ * @throw          [assert]              - If the vector is NULL
+ * @throw          [assert]              - If the key function is NULL
+ */
+void Vector_sort_radix_by_key(void *vec_ptr, Vector_Scalar_Type key_type, Vector_radix_key_fn key_fn);
+
+/**
+ * Public
+ * 
+ * Sorts a vector in place on several threads, stable: each thread merge sorts a chunk of the vector,
+ * then the chunks are merged pairwise, every thread producing an equal share of the output of each merge round
+ * Vectors shorter than twice VECTOR_PARALLEL_SORT_MIN_CHUNK are sorted on the calling thread
+ * Runs on the pool of the parallel functions, allocates a single scratch buffer of the size of the vector from its allocator
+ * @param vec_ptr      [T**]               - A reference to the vector
+ * @param compare_fn   [Vector_compare_fn] - Compares two elements through pointers to them (qsort style), called from every thread
+ * @param thread_count [size_t]            - The number of chunks sorted in parallel, 0 for the number of threads of the pool
+ * @throw              [assert]            - If the reference to the vector is NULL
+ * @throw              [assert]            - If the vector is NULL
+ * @throw              [assert]            - If the compare function is NULL
+ */
+void Vector_sort_parallel(void *vec_ptr, Vector_compare_fn compare_fn, size_t thread_count);
+
+/**
+ * Public
+ * 
+ * Sets the number of threads of the parallel functions (the calling one included), the pool is restarted with that many threads by the next parallel call
+ * Must not be called from a function run by a parallel function
+ * @param thread_count [size_t] - The number of threads, 0 for one per online processor, up to 64
+ */
+void Vector_parallel_set_thread_count(size_t thread_count);
+
+/**
+ * Public
+ * 
+ * Returns the number of threads of the parallel functions
+ * @return [size_t] - The number of threads, the calling one included (one per online processor unless set, 1 without VECTOR_THREADS)
+ */
+size_t Vector_parallel_get_thread_count(void);
 
 /**
  * Public
  * 
- * Gets the size of an element in the vector
- * @param vec_ptr [T**]    - A reference to the vector
- * @return        [size_t] - The element size of the vector
- * @throw         [assert] - If the reference to the vector is NULL
- * @throw         [assert] - If the vector is NULL
+ * Sets the grain size of Vector_parallel_foreach/map/reduce: the fewest elements a thread takes at once,
+ * raise it when the function is cheap, lower it when a few elements are already a lot of work
+ * @param grain_size [size_t] - The number of elements (VECTOR_PARALLEL_GRAIN_SIZE by default)
+ * @throw            [assert] - If the grain size is 0
  */
-size_t Vector_get_element_size(void *vec_ptr);
+void Vector_parallel_set_grain_size(size_t grain_size);
 
 /**
  * Public
  * 
- * Returns the number of elements in a vector
- * @param vec_ptr [T**]    - A reference to the vector
- * @return        [size_t] - The number of elements in the vector
- * @throw         [assert] - If the reference to the vector is NULL
- * @throw         [assert] - If the vector is NULL
+ * Returns the grain size of Vector_parallel_foreach/map/reduce
+ * @return [size_t] - The number of elements
  */
-size_t Vector_get_length(void *vec_ptr);
+size_t Vector_parallel_get_grain_size(void);
 
 /**
  * Public
  * 
- * Returns the capacity of a vector
- * @param vec_ptr [T**]    - A reference to the vector
- * @return        [size_t] - The capacity of the vector
- * @throw         [assert] - If the reference to the vector is NULL
- * @throw         [assert] - If the vector is NULL
+ * Stops the threads of the pool of the parallel functions, the next parallel call starts them again
+ * Must not be called from a function run by a parallel function
  */
-size_t Vector_get_capacity(void *vec_ptr);
+void Vector_parallel_shutdown(void);
 
 /**
  * Public
  * 
- * Returns the initial capacity of a vector
- * @param vec_ptr [T**]    - A reference to the vector
- * @return        [size_t] - The initial capacity of the vector
- * @throw         [assert] - If the reference to the vector is NULL
- * @throw         [assert] - If the vector is NULL
+ * Calls a function on every element of the vector, on the threads of the pool: the vector is cut in chunks of at least the grain size,
+ * each thread runs its share of the chunks then steals from the others
+ * @param vec_ptr    [T**]                        - A reference to the vector
+ * @param foreach_fn [Vector_parallel_foreach_fn] - The function, it takes a pointer to the element and may modify it
+ * @param context    [void*]                      - Passed to the function
+ * @throw            [assert]                     - If the reference to the vector is NULL
+ * @throw            [assert]                     - If the vector is NULL
+ * @throw            [assert]                     - If the function is NULL
  */
-size_t Vector_get_initial_capacity(void *vec_ptr);
+void Vector_parallel_foreach(void *vec_ptr, Vector_parallel_foreach_fn foreach_fn, void *context);
 
 /**
  * Public
  * 
- * Checks if the vector is full
- * @param vec_ptr [T**]    - A reference to the vector
- * @return        [bool]   - True if the vector is full, false otherwise
- * @throw         [assert] - If the reference to the vector is NULL
- * @throw         [assert] - If the vector is NULL
+ * Maps every element of the vector into a new vector, on the threads of the pool (see Vector_parallel_foreach),
+ * the new vector is allocated once with the length of the vector and the threads write into it directly
+ * @param vec_ptr      [T**]                    - A reference to the vector
+ * @param map_fn       [Vector_parallel_map_fn] - The mapper, writes the mapped element to its result
+ * @param element_size [size_t]                 - The size of the elements of the new vector
+ * @param context      [void*]                  - Passed to the mapper
+ * @return             [U*]                     - The new vector, with the allocator of the vector
+ * @throw              [assert]                 - If the reference to the vector is NULL
+ * @throw              [assert]                 - If the vector is NULL
+ * @throw              [assert]                 - If the mapper is NULL
  */
-bool Vector_is_full(void *vec_ptr);
+void *Vector_parallel_map(void *vec_ptr, Vector_parallel_map_fn map_fn, size_t element_size, void *context);
 
 /**
  * Public
  * 
- * Returns true if the capacity is less than half full (there is a lot of unused space) and capacity > initial_capacity (the initial_capacity is the minimum capacity)
- * @param vec_ptr [T**]    - A reference to the vector
- * @return        [bool]   - True if the vector is underfilled, false otherwise
- * @throw         [assert] - If the reference to the vector is NULL
- * @throw         [assert] - If the vector is NULL
+ * Reduces the vector on the threads of the pool (see Vector_parallel_foreach): every chunk is folded into its own copy of the initial accumulator,
+ * then the partial accumulators are combined into the accumulator in the order of the chunks
+ * The initial accumulator must be an identity of the combiner (0 for a sum, 1 for a product, ...), and the combiner associative
+ * @param vec_ptr          [T**]                        - A reference to the vector
+ * @param reduce_fn        [Vector_parallel_reduce_fn]  - Folds an element into an accumulator
+ * @param combine_fn       [Vector_parallel_combine_fn] - Folds a partial accumulator into another one
+ * @param accumulator      [U*]                         - The initial accumulator, receives the result
+ * @param accumulator_size [size_t]                     - The size of the accumulator
+ * @param context          [void*]                      - Passed to the functions
+ * @throw                  [assert]                     - If the reference to the vector is NULL
+ * @throw                  [assert]                     - If the vector is NULL
+ * @throw                  [assert]                     - If a function or the accumulator is NULL
+ * @throw                  [assert]                     - If the partial accumulators cannot be allocated
  */
-bool Vector_is_underfilled(void *vec_ptr);
+void Vector_parallel_reduce(void *vec_ptr, Vector_parallel_reduce_fn reduce_fn, Vector_parallel_combine_fn combine_fn, void *accumulator, size_t accumulator_size, void *context);
 
 /**
  * Public
  * 
- * Checks if the vector is empty
- * @param vec_ptr [T**]    - A reference to the vector
- * @return        [bool]   - True if the vector is empty, false otherwise
- * @throw         [assert] - If the reference to the vector is NULL
- * @throw         [assert] - If the vector is NULL
+ * Filters the vector into a new vector on the threads of the pool (see Vector_parallel_foreach), keeping the order of the elements:
+ * the threads evaluate the predicate on their chunks and count the matches, a prefix sum of the counts gives where the matches of each chunk go,
+ * then the threads copy the matches of their chunks to the new vector, allocated once with the exact number of matches
+ * The predicate is called once per element, its results are kept in a byte per element allocated from the allocator of the vector
+ * @param vec_ptr      [T**]                          - A reference to the vector
+ * @param predicate_fn [Vector_parallel_predicate_fn] - Returns true for the elements to keep
+ * @param context      [void*]                        - Passed to the predicate
+ * @return             [T*]                           - The new vector, with the allocator of the vector
+ * @throw              [assert]                       - If the reference to the vector is NULL
+ * @throw              [assert]                       - If the vector is NULL
+ * @throw              [assert]                       - If the predicate is NULL
+ * @throw              [assert]                       - If the counts or the results of the predicate cannot be allocated
  */
-bool Vector_is_empty(void *vec_ptr);
+void *Vector_parallel_filter(void *vec_ptr, Vector_parallel_predicate_fn predicate_fn, void *context);
 
 /**
  * Public
  * 
- * Sets the custom free function of the vector
- * @param vec_ptr [T**]            - a reference to the vector
- * @param free_fn [Vector_free_fn] - the free function to free the vector
- * @throw         [assert]         - if the reference to the vector is NULL
- * @throw         [assert]         - if the vector is NULL
+ * Finds the first element equal to a value in a vector of integers or floats, comparing a whole SIMD register of elements at a time
+ * (memchr for the 8 bit types), floats compare as in C: NaN equals nothing, -0.0 equals 0.0
+ * Vector_index_of/Vector_any with an equality comparator, without a call per element
+ * @param vec_ptr [T**]                - A reference to the vector
+ * @param type    [Vector_Scalar_Type] - The type of the elements
+ * @param value   [T*]                 - A pointer to the value
+ * @return        [size_t]             - The index of the first equal element, VECTOR_NPOS if there is none
+ * @throw         [assert]             - If the reference to the vector is NULL
+ * @throw         [assert]             - If the vector is NULL
+ * @throw         [assert]             - If the element size is not the size of the type
  */
-void Vector_set_free_fn(void *vec_ptr, Vector_free_fn free_fn);
+size_t Vector_find_eq(void *vec_ptr, Vector_Scalar_Type type, const void *value);
 
 /**
  * Public
  * 
- * Sets the custom initial capacity of the vector and resizes it immediately
- * The default initial capacity is 4
- * @param vec_ptr          [T**]    - A reference to the vector
- * @param initial_capacity [size_t] - The initial capacity of the vector
- * @throw                  [assert] - If the reference to the vector is NULL
- * @throw                  [assert] - If the vector is NULL
+ * Counts the elements equal to a value in a vector of integers or floats, a SIMD register of elements at a time (see Vector_find_eq)
+ * @param vec_ptr [T**]                - A reference to the vector
+ * @param type    [Vector_Scalar_Type] - The type of the elements
+ * @param value   [T*]                 - A pointer to the value
+ * @return        [size_t]             - The number of equal elements
+ * @throw         [assert]             - If the reference to the vector is NULL
+ * @throw         [assert]             - If the vector is NULL
+ * @throw         [assert]             - If the element size is not the size of the type
  */
-void Vector_set_initial_capacity(void *vec_ptr, size_t initial_capacity);
+size_t Vector_count_eq(void *vec_ptr, Vector_Scalar_Type type, const void *value);
 
 /**
  * Public
  * 
- * Sets the custom function that calculates the optimal capacity of the vector
- * @param vec_ptr                       [T**]                                  - A reference to the vector
- * @param calculate_optimal_capacity_fn [Vector_calculate_optimal_capacity_fn] - The function that calculates the optimal capacity of the vector
- * @throw                               [assert]                               - If the reference to the vector is NULL
- * @throw                               [assert]                               - If the vector is NULL
+ * Counts the elements in [low, high] in a vector of integers or floats, a SIMD register of elements at a time (see Vector_find_eq),
+ * Vector_all of a range check is Vector_count_range(...) == Vector_get_length(...)
+ * @param vec_ptr [T**]                - A reference to the vector
+ * @param type    [Vector_Scalar_Type] - The type of the elements
+ * @param low     [T*]                 - A pointer to the lowest value counted
+ * @param high    [T*]                 - A pointer to the highest value counted
+ * @return        [size_t]             - The number of elements e with low <= e <= high
+ * @throw         [assert]             - If the reference to the vector is NULL
+ * @throw         [assert]             - If the vector is NULL
+ * @throw         [assert]             - If the element size is not the size of the type
  */
-void Vector_set_calculate_optimal_capacity_fn(void *vec_ptr, Vector_calculate_optimal_capacity_fn calculate_optimal_capacity_fn);
+size_t Vector_count_range(void *vec_ptr, Vector_Scalar_Type type, const void *low, const void *high);
 
 /**
  * Public
@@ -208,11 +1215,11 @@ void Vector_set_calculate_optimal_capacity_fn(void *vec_ptr, Vector_calculate_op
 #define Vector_destroy(__vec_ptr__) do {                              \
     assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");       \
     __Vector_Header *__header__ = __vector_get_header((__vec_ptr__)); \
-    if (__header__->free_fn == NULL) {                                \
-        free(__header__);                                             \
-        (*(__vec_ptr__)) = NULL;                                      \
+    if (__VECTOR_TRAIT(__header__, free_fn) == NULL) {                \
+        __vector_free_elements((__vec_ptr__), 0, __header__->length); \
+        Vector_deallocate((__vec_ptr__));                             \
     } else {                                                          \
-        __header__->free_fn((void*)(__vec_ptr__));                    \
+        __VECTOR_TRAIT(__header__, free_fn)((void*)(__vec_ptr__));    \
     }                                                                 \
 } while (0)
 
@@ -327,11 +1334,14 @@ void Vector_set_calculate_optimal_capacity_fn(void *vec_ptr, Vector_calculate_op
  * @throw             [assert] - If the vector is NULL
  * @throw             [assert] - If malloc fails
  */
-#define Vector_push(__vec_ptr__, __value__) do {                      \
-    assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");       \
-    __vector_resize_if_needed((__vec_ptr__));                         \
-    __Vector_Header *__header__ = __vector_get_header((__vec_ptr__)); \
-    (*(__vec_ptr__))[__header__->length++] = (__value__);             \
+#define Vector_push(__vec_ptr__, __value__) do {                                                                           \
+    assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                                            \
+    __Vector_Header *__header__ = __vector_header__(*(__vec_ptr__));                                                       \
+    if (__header__->length >= __header__->capacity || __VECTOR_TRAIT(__header__, calculate_optimal_capacity_fn) != NULL) { \
+        __vector_grow((__vec_ptr__));                                                                                      \
+        __header__ = __vector_header__(*(__vec_ptr__));                                                                    \
+    }                                                                                                                      \
+    (*(__vec_ptr__))[__header__->length++] = (__value__);                                                                  \
 } while (0)
 
 /**
@@ -346,14 +1356,17 @@ void Vector_set_calculate_optimal_capacity_fn(void *vec_ptr, Vector_calculate_op
  * @throw             [assert] - If the index is out of bounds
  * @throw             [assert] - If malloc fails
  */
-#define Vector_insert_at(__vec_ptr__, __index__, __value__) do {                                                                                           \
-    assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                                                                            \
-    __Vector_Header *__header__ = __vector_get_header((__vec_ptr__));                                                                                      \
-    assertf((__index__) >= 0 && (__index__) <= __header__->length, "ERROR: Index: %d out of bounds [%d, %zu]\n", (int)(__index__), 0, __header__->length); \
-    __vector_resize_if_needed((__vec_ptr__));                                                                                                              \
-    memmove((*(__vec_ptr__)) + (__index__) + 1, (*(__vec_ptr__)) + (__index__), (__header__->length - (__index__)) * __header__->element_size);            \
-    (*(__vec_ptr__))[(__index__)] = (__value__);                                                                                                           \
-    __header__->length++;                                                                                                                                  \
+#define Vector_insert_at(__vec_ptr__, __index__, __value__) do {                                                                                                   \
+    assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                                                                                    \
+    __Vector_Header *__header__ = __vector_header__(*(__vec_ptr__));                                                                                               \
+    assertf((__index__) >= 0 && (__index__) <= __header__->length, "ERROR: Index: %d out of bounds [%d, %zu]\n", (int)(__index__), 0, (size_t)__header__->length); \
+    if (__header__->length >= __header__->capacity || __VECTOR_TRAIT(__header__, calculate_optimal_capacity_fn) != NULL) {                                         \
+        __vector_grow((__vec_ptr__));                                                                                                                              \
+        __header__ = __vector_header__(*(__vec_ptr__));                                                                                                            \
+    }                                                                                                                                                              \
+    memmove((*(__vec_ptr__)) + (__index__) + 1, (*(__vec_ptr__)) + (__index__), (__header__->length - (__index__)) * __VECTOR_TRAIT(__header__, element_size));    \
+    (*(__vec_ptr__))[(__index__)] = (__value__);                                                                                                                   \
+    __header__->length++;                                                                                                                                          \
 } while (0)
 
 #if COMPILER_SUPPORTS_STATEMENT_EXPRESSIONS
@@ -371,7 +1384,6 @@ void Vector_set_calculate_optimal_capacity_fn(void *vec_ptr, Vector_calculate_op
      */
     #define Vector_insert_sorted(__vec_ptr__, __value__, __ordering_comparator__) ({      \
         assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                       \
-        __vector_resize_if_needed((__vec_ptr__));                                         \
         __Vector_Header *__header__ = __vector_get_header((__vec_ptr__));                 \
         size_t __low__ = 0;                                                               \
         size_t __high__ = __header__->length;                                             \
@@ -401,7 +1413,6 @@ void Vector_set_calculate_optimal_capacity_fn(void *vec_ptr, Vector_calculate_op
      */
     #define Vector_insert_sorted(__vec_ptr__, __value__, __ordering_comparator__, __result_ptr__) do { \
         assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                    \
-        __vector_resize_if_needed((__vec_ptr__));                                                      \
         __Vector_Header *__header__ = __vector_get_header((__vec_ptr__));                              \
         size_t __low__ = 0;                                                                            \
         size_t __high__ = __header__->length;                                                          \
@@ -421,21 +1432,48 @@ void Vector_set_calculate_optimal_capacity_fn(void *vec_ptr, Vector_calculate_op
 /**
  * Public
  * 
- * Appends a copy of the values in the second vector to the first vector
+ * Appends a copy of the values in the second vector to the first vector, growing it at most once and copying them with a single memcpy
+ * The two references may point to the same vector
  * @param __vec_ptr1__ [T**]    - A reference to the first vector
  * @param __vec_ptr2__ [T**]    - A reference to the second vector
  * @throw              [assert] - If the reference to the first vector is NULL
  * @throw              [assert] - If the first vector is NULL
  * @throw              [assert] - If the reference to the second vector is NULL
  * @throw              [assert] - If the second vector is NULL
+ * @throw              [assert] - If the vectors have different element sizes
  * @throw              [assert] - If malloc fails
  */
-#define Vector_concat(__vec_ptr1__, __vec_ptr2__) do {                           \
-    assertf(*(__vec_ptr1__) != NULL, "ERROR: First vector is NULL\n");           \
-    assertf(*(__vec_ptr2__) != NULL, "ERROR: Second vector is NULL\n");          \
-    for (size_t __i__ = 0; __i__ < Vector_get_length((__vec_ptr2__)); __i__++) { \
-        Vector_push((__vec_ptr1__), (*(__vec_ptr2__))[__i__]);                   \
-    }                                                                            \
+#define Vector_concat(__vec_ptr1__, __vec_ptr2__) do {                                                                                                \
+    assertf(*(__vec_ptr1__) != NULL, "ERROR: First vector is NULL\n");                                                                                \
+    assertf(*(__vec_ptr2__) != NULL, "ERROR: Second vector is NULL\n");                                                                               \
+    assertf(Vector_get_element_size((__vec_ptr1__)) == Vector_get_element_size((__vec_ptr2__)), "ERROR: The vectors have different element sizes\n"); \
+    Vector_extend_from_array((__vec_ptr1__), *(__vec_ptr2__), Vector_get_length((__vec_ptr2__)));                                                     \
+} while (0)
+
+/**
+ * Public
+ * 
+ * Appends `__count__` copies of a value to the end of the vector, growing it at most once
+ * @param __vec_ptr__ [T**]    - A reference to the vector
+ * @param __value__   [T]      - The value to append, evaluated once
+ * @param __count__   [size_t] - The number of copies to append
+ * @throw             [assert] - If the reference to the vector is NULL
+ * @throw             [assert] - If the vector is NULL
+ * @throw             [assert] - If malloc fails
+ */
+#define Vector_push_n(__vec_ptr__, __value__, __count__) do {                  \
+    assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                \
+    size_t __count_n__ = (__count__);                                          \
+    if (__count_n__ > 0) {                                                     \
+        __vector_reserve_more((__vec_ptr__), __count_n__);                     \
+        __Vector_Header *__header__ = __vector_header__(*(__vec_ptr__));       \
+        size_t __first__ = __header__->length;                                 \
+        (*(__vec_ptr__))[__first__] = (__value__);                             \
+        for (size_t __i__ = 1; __i__ < __count_n__; __i__++) {                 \
+            (*(__vec_ptr__))[__first__ + __i__] = (*(__vec_ptr__))[__first__]; \
+        }                                                                      \
+        __header__->length += __count_n__;                                     \
+    }                                                                          \
 } while (0)
 
 #if COMPILER_SUPPORTS_STATEMENT_EXPRESSIONS
@@ -518,15 +1556,15 @@ void Vector_set_calculate_optimal_capacity_fn(void *vec_ptr, Vector_calculate_op
          * @throw             [assert] - If malloc fails
          * @throw             [assert] - If the index is out of bounds
          */
-        #define Vector_remove_at(__vec_ptr__, __index__) ({                                                                                                           \
-            assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                                                                               \
-            __Vector_Header *__header__ = __vector_get_header((__vec_ptr__));                                                                                         \
-            assertf((__index__) >= 0 && (__index__) < __header__->length, "ERROR: Index: %d out of bounds [%d, %zu]\n", (int)(__index__), 0, __header__->length - 1); \
-            typeof(**(__vec_ptr__)) __value__ = (*(__vec_ptr__))[(__index__)];                                                                                        \
-            memmove((*(__vec_ptr__)) + (__index__), (*(__vec_ptr__)) + (__index__) + 1, (__header__->length - (__index__) - 1) * __header__->element_size);           \
-            __header__->length--;                                                                                                                                     \
-            __vector_resize_if_needed((__vec_ptr__));                                                                                                                 \
-            __value__;                                                                                                                                                \
+        #define Vector_remove_at(__vec_ptr__, __index__) ({                                                                                                                   \
+            assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                                                                                       \
+            __Vector_Header *__header__ = __vector_get_header((__vec_ptr__));                                                                                                 \
+            assertf((__index__) >= 0 && (__index__) < __header__->length, "ERROR: Index: %d out of bounds [%d, %zu]\n", (int)(__index__), 0, (size_t)__header__->length - 1); \
+            typeof(**(__vec_ptr__)) __value__ = (*(__vec_ptr__))[(__index__)];                                                                                                \
+            memmove((*(__vec_ptr__)) + (__index__), (*(__vec_ptr__)) + (__index__) + 1, (__header__->length - (__index__) - 1) * __VECTOR_TRAIT(__header__, element_size));   \
+            __header__->length--;                                                                                                                                             \
+            __vector_resize_if_needed((__vec_ptr__));                                                                                                                         \
+            __value__;                                                                                                                                                        \
         })
     #else // COMPILER_SUPPORTS_TYPEOF
         /**
@@ -541,15 +1579,15 @@ void Vector_set_calculate_optimal_capacity_fn(void *vec_ptr, Vector_calculate_op
          * @throw                      [assert] - If malloc fails
          * @throw                      [assert] - If the index is out of bounds
          */
-        #define Vector_remove_at(__vec_ptr__, __index__, __vec_element_type__) ({                                                                                     \
-            assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                                                                               \
-            __Vector_Header *__header__ = __vector_get_header((__vec_ptr__));                                                                                         \
-            assertf((__index__) >= 0 && (__index__) < __header__->length, "ERROR: Index: %d out of bounds [%d, %zu]\n", (int)(__index__), 0, __header__->length - 1); \
-            __vec_element_type__ __value__ = (*(__vec_ptr__))[(__index__)];                                                                                           \
-            memmove((*(__vec_ptr__)) + (__index__), (*(__vec_ptr__)) + (__index__) + 1, (__header__->length - (__index__) - 1) * __header__->element_size);           \
-            __header__->length--;                                                                                                                                     \
-            __vector_resize_if_needed((__vec_ptr__));                                                                                                                 \
-            __value__;                                                                                                                                                \
+        #define Vector_remove_at(__vec_ptr__, __index__, __vec_element_type__) ({                                                                                             \
+            assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                                                                                       \
+            __Vector_Header *__header__ = __vector_get_header((__vec_ptr__));                                                                                                 \
+            assertf((__index__) >= 0 && (__index__) < __header__->length, "ERROR: Index: %d out of bounds [%d, %zu]\n", (int)(__index__), 0, (size_t)__header__->length - 1); \
+            __vec_element_type__ __value__ = (*(__vec_ptr__))[(__index__)];                                                                                                   \
+            memmove((*(__vec_ptr__)) + (__index__), (*(__vec_ptr__)) + (__index__) + 1, (__header__->length - (__index__) - 1) * __VECTOR_TRAIT(__header__, element_size));   \
+            __header__->length--;                                                                                                                                             \
+            __vector_resize_if_needed((__vec_ptr__));                                                                                                                         \
+            __value__;                                                                                                                                                        \
         })
     #endif // COMPILER_SUPPORTS_TYPEOF
 #else // COMPILER_SUPPORTS_STATEMENT_EXPRESSIONS
@@ -565,16 +1603,88 @@ void Vector_set_calculate_optimal_capacity_fn(void *vec_ptr, Vector_calculate_op
      * @throw                [assert] - If malloc fails
      * @throw                [assert] - If the index is out of bounds
      */
-    #define Vector_remove_at(__vec_ptr__, __index__, __result_ptr__) do {                                                                                         \
-        assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                                                                               \
-        __Vector_Header *__header__ = __vector_get_header((__vec_ptr__));                                                                                         \
-        assertf((__index__) >= 0 && (__index__) < __header__->length, "ERROR: Index: %d out of bounds [%d, %zu]\n", (int)(__index__), 0, __header__->length - 1); \
-        if ((__result_ptr__) != NULL) {                                                                                                                           \
-            (*(__result_ptr__)) = (*(__vec_ptr__))[(__index__)];                                                                                                  \
-        }                                                                                                                                                         \
-        memmove((*(__vec_ptr__)) + (__index__), (*(__vec_ptr__)) + (__index__) + 1, (__header__->length - (__index__) - 1) * __header__->element_size);           \
-        __header__->length--;                                                                                                                                     \
-        __vector_resize_if_needed((__vec_ptr__));                                                                                                                 \
+    #define Vector_remove_at(__vec_ptr__, __index__, __result_ptr__) do {                                                                                                 \
+        assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                                                                                       \
+        __Vector_Header *__header__ = __vector_get_header((__vec_ptr__));                                                                                                 \
+        assertf((__index__) >= 0 && (__index__) < __header__->length, "ERROR: Index: %d out of bounds [%d, %zu]\n", (int)(__index__), 0, (size_t)__header__->length - 1); \
+        if ((__result_ptr__) != NULL) {                                                                                                                                   \
+            (*(__result_ptr__)) = (*(__vec_ptr__))[(__index__)];                                                                                                          \
+        }                                                                                                                                                                 \
+        memmove((*(__vec_ptr__)) + (__index__), (*(__vec_ptr__)) + (__index__) + 1, (__header__->length - (__index__) - 1) * __VECTOR_TRAIT(__header__, element_size));   \
+        __header__->length--;                                                                                                                                             \
+        __vector_resize_if_needed((__vec_ptr__));                                                                                                                         \
+    } while (0)
+#endif // COMPILER_SUPPORTS_STATEMENT_EXPRESSIONS
+
+#if COMPILER_SUPPORTS_STATEMENT_EXPRESSIONS
+    #if COMPILER_SUPPORTS_TYPEOF
+        /**
+         * Public
+         * 
+         * Removes the value at the specified index in O(1) by moving the last element into its place, the order is not preserved
+         * @param __vec_ptr__ [T**]    - A reference to the vector
+         * @param __index__   [size_t] - The index to remove the value from
+         * @return            [T]      - The value removed from the vector
+         * @throw             [assert] - If the vector is NULL
+         * @throw             [assert] - If the index is out of bounds
+         */
+        #define Vector_swap_remove(__vec_ptr__, __index__) ({                                                                                               \
+            assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                                                                     \
+            __Vector_Header *__header__ = __vector_get_header((__vec_ptr__));                                                                               \
+            size_t __swap_index__ = (__index__);                                                                                                            \
+            assertf(__swap_index__ < __header__->length, "ERROR: Index: %zu out of bounds [%d, %zu]\n", __swap_index__, 0, (size_t)__header__->length - 1); \
+            typeof(**(__vec_ptr__)) __value__ = (*(__vec_ptr__))[__swap_index__];                                                                           \
+            (*(__vec_ptr__))[__swap_index__] = (*(__vec_ptr__))[__header__->length - 1];                                                                    \
+            __header__->length--;                                                                                                                           \
+            __vector_resize_if_needed((__vec_ptr__));                                                                                                       \
+            __value__;                                                                                                                                      \
+        })
+    #else // COMPILER_SUPPORTS_TYPEOF
+        /**
+         * Public
+         * 
+         * Removes the value at the specified index in O(1) by moving the last element into its place, the order is not preserved
+         * @param __vec_ptr__          [T**]    - A reference to the vector
+         * @param __index__            [size_t] - The index to remove the value from
+         * @param __vec_element_type__ [type]   - The type of the vector elements
+         * @return                     [T]      - The value removed from the vector
+         * @throw                      [assert] - If the vector is NULL
+         * @throw                      [assert] - If the index is out of bounds
+         */
+        #define Vector_swap_remove(__vec_ptr__, __index__, __vec_element_type__) ({                                                                         \
+            assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                                                                     \
+            __Vector_Header *__header__ = __vector_get_header((__vec_ptr__));                                                                               \
+            size_t __swap_index__ = (__index__);                                                                                                            \
+            assertf(__swap_index__ < __header__->length, "ERROR: Index: %zu out of bounds [%d, %zu]\n", __swap_index__, 0, (size_t)__header__->length - 1); \
+            __vec_element_type__ __value__ = (*(__vec_ptr__))[__swap_index__];                                                                              \
+            (*(__vec_ptr__))[__swap_index__] = (*(__vec_ptr__))[__header__->length - 1];                                                                    \
+            __header__->length--;                                                                                                                           \
+            __vector_resize_if_needed((__vec_ptr__));                                                                                                       \
+            __value__;                                                                                                                                      \
+        })
+    #endif // COMPILER_SUPPORTS_TYPEOF
+#else // COMPILER_SUPPORTS_STATEMENT_EXPRESSIONS
+    /**
+     * Public
+     * 
+     * Removes the value at the specified index in O(1) by moving the last element into its place, the order is not preserved
+     * @param __vec_ptr__    [T**]    - A reference to the vector
+     * @param __index__      [size_t] - The index to remove the value from
+     * @param __result_ptr__ [T*]     - A pointer to the variable to store the removed value in, if NULL, the result will not be stored but the function will execute normally
+     * @throw                [assert] - If the vector is NULL
+     * @throw                [assert] - If the index is out of bounds
+     */
+    #define Vector_swap_remove(__vec_ptr__, __index__, __result_ptr__) do {                                                                             \
+        assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                                                                     \
+        __Vector_Header *__header__ = __vector_get_header((__vec_ptr__));                                                                               \
+        size_t __swap_index__ = (__index__);                                                                                                            \
+        assertf(__swap_index__ < __header__->length, "ERROR: Index: %zu out of bounds [%d, %zu]\n", __swap_index__, 0, (size_t)__header__->length - 1); \
+        if ((__result_ptr__) != NULL) {                                                                                                                 \
+            (*(__result_ptr__)) = (*(__vec_ptr__))[__swap_index__];                                                                                     \
+        }                                                                                                                                               \
+        (*(__vec_ptr__))[__swap_index__] = (*(__vec_ptr__))[__header__->length - 1];                                                                    \
+        __header__->length--;                                                                                                                           \
+        __vector_resize_if_needed((__vec_ptr__));                                                                                                       \
     } while (0)
 #endif // COMPILER_SUPPORTS_STATEMENT_EXPRESSIONS
 
@@ -669,6 +1779,98 @@ void Vector_set_calculate_optimal_capacity_fn(void *vec_ptr, Vector_calculate_op
 #endif // COMPILER_SUPPORTS_STATEMENT_EXPRESSIONS
 
 
+/**
+ * Internal
+ * 
+ * Compacts the vector in a single pass, keeping in order the elements for which the predicate returns `__keep__`
+ * The dropped elements are released with the element free function and, if `__shrink__`, the capacity is shrunk at most once, at the end
+ * @param __vec_ptr__     [T**]         - A reference to the vector
+ * @param __predicate__   [bool (*)(T)] - The predicate function
+ * @param __keep__        [bool]        - The predicate result of the elements to keep
+ * @param __shrink__      [bool]        - Whether to shrink the capacity after the compaction
+ * @param __removed_ptr__ [size_t*]     - Receives the number of removed elements, NULL to ignore it
+ * @throw                 [assert]      - If the reference to the vector is NULL
+ * @throw                 [assert]      - If the vector is NULL
+ */
+#define __vector_compact__(__vec_ptr__, __predicate__, __keep__, __shrink__, __removed_ptr__) do {   \
+    assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                      \
+    __Vector_Header *__header__ = __vector_get_header((__vec_ptr__));                                \
+    Vector_element_free_fn __element_free_fn__ = __VECTOR_TRAIT(__header__, element_free_fn);        \
+    size_t __length__ = __header__->length;                                                          \
+    size_t __write__ = 0;                                                                            \
+    for (size_t __read__ = 0; __read__ < __length__; __read__++) {                                   \
+        if ((bool)(__predicate__)((*(__vec_ptr__))[__read__]) == (bool)(__keep__)) {                 \
+            if (__write__ != __read__) { (*(__vec_ptr__))[__write__] = (*(__vec_ptr__))[__read__]; } \
+            __write__++;                                                                             \
+        } else if (__element_free_fn__ != NULL) {                                                    \
+            __element_free_fn__(&(*(__vec_ptr__))[__read__]);                                        \
+        }                                                                                            \
+    }                                                                                                \
+    __header__->length = __write__;                                                                  \
+    if ((__shrink__) && __write__ != __length__) { __vector_resize_if_needed((__vec_ptr__)); }       \
+    size_t *__removed_out__ = (__removed_ptr__);                                                     \
+    if (__removed_out__ != NULL) { (*__removed_out__) = __length__ - __write__; }                    \
+} while (0)
+
+#if COMPILER_SUPPORTS_STATEMENT_EXPRESSIONS
+    /**
+     * Public
+     * 
+     * Keeps only the elements for which the predicate returns true, in place and in order
+     * @param __vec_ptr__   [T**]         - A reference to the vector
+     * @param __predicate__ [bool (*)(T)] - The predicate function, called once per element
+     * @return              [size_t]      - The number of removed elements
+     * @throw               [assert]      - If the reference to the vector is NULL
+     * @throw               [assert]      - If the vector is NULL
+     */
+    #define Vector_retain(__vec_ptr__, __predicate__) ({                              \
+        size_t __removed__;                                                           \
+        __vector_compact__((__vec_ptr__), (__predicate__), true, true, &__removed__); \
+        __removed__;                                                                  \
+    })
+
+    /**
+     * Public
+     * 
+     * Removes the elements for which the predicate returns true, in place, the other elements keep their order
+     * @param __vec_ptr__   [T**]         - A reference to the vector
+     * @param __predicate__ [bool (*)(T)] - The predicate function, called once per element
+     * @return              [size_t]      - The number of removed elements
+     * @throw               [assert]      - If the reference to the vector is NULL
+     * @throw               [assert]      - If the vector is NULL
+     */
+    #define Vector_remove_if(__vec_ptr__, __predicate__) ({                            \
+        size_t __removed__;                                                            \
+        __vector_compact__((__vec_ptr__), (__predicate__), false, true, &__removed__); \
+        __removed__;                                                                   \
+    })
+#else // COMPILER_SUPPORTS_STATEMENT_EXPRESSIONS
+    /**
+     * Public
+     * 
+     * Keeps only the elements for which the predicate returns true, in place and in order
+     * @param __vec_ptr__    [T**]         - A reference to the vector
+     * @param __predicate__  [bool (*)(T)] - The predicate function, called once per element
+     * @param __result_ptr__ [size_t*]     - Receives the number of removed elements, NULL to ignore it
+     * @throw                [assert]      - If the reference to the vector is NULL
+     * @throw                [assert]      - If the vector is NULL
+     */
+    #define Vector_retain(__vec_ptr__, __predicate__, __result_ptr__) __vector_compact__((__vec_ptr__), (__predicate__), true, true, (__result_ptr__))
+
+    /**
+     * Public
+     * 
+     * Removes the elements for which the predicate returns true, in place, the other elements keep their order
+     * @param __vec_ptr__    [T**]         - A reference to the vector
+     * @param __predicate__  [bool (*)(T)] - The predicate function, called once per element
+     * @param __result_ptr__ [size_t*]     - Receives the number of removed elements, NULL to ignore it
+     * @throw                [assert]      - If the reference to the vector is NULL
+     * @throw                [assert]      - If the vector is NULL
+     */
+    #define Vector_remove_if(__vec_ptr__, __predicate__, __result_ptr__) __vector_compact__((__vec_ptr__), (__predicate__), false, true, (__result_ptr__))
+#endif // COMPILER_SUPPORTS_STATEMENT_EXPRESSIONS
+
+
 /**
  * Public
  * 
@@ -680,51 +1882,56 @@ void Vector_set_calculate_optimal_capacity_fn(void *vec_ptr, Vector_calculate_op
 #define Vector_clear(__vec_ptr__) do {                                \
     assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");       \
     __Vector_Header *__header__ = __vector_get_header((__vec_ptr__)); \
+    __vector_free_elements((__vec_ptr__), 0, __header__->length);     \
     __header__->length = 0;                                           \
     __vector_resize_if_needed((__vec_ptr__));                         \
 } while (0)
 
 
+/**
+ * Internal
+ * 
+ * Returns a shallow copy of the vector, allocated from the allocator of the vector
+ * @param vec_ptr [T**]    - A reference to the vector
+ * @return        [T*]     - The copied vector
+ * @throw         [assert] - If the reference to the vector is NULL
+ * @throw         [assert] - If the vector is NULL
+ * @throw         [assert] - If the allocation fails
+ */
+void *__vector_copy(void *vec_ptr);
+
 // the result is casted to void* to avoid the casting warning
 #if COMPILER_SUPPORTS_STATEMENT_EXPRESSIONS
     /**
      * Public
      * 
-     * Returns a shallow copy of the vector
+     * Returns a shallow copy of the vector, the copy uses the allocator of the vector
      * @param __vec_ptr__ [T**]    - A reference to the vector
      * @return            [T*]     - The copied vector
      * @throw             [assert] - If the reference to the vector is NULL
      * @throw             [assert] - If the vector is NULL
-     * @throw             [assert] - If malloc fails
+     * @throw             [assert] - If the allocation fails
      * @note the returned result is a shallow copy, if the vector contains pointers to objects, the objects will not be copied
      */
-    #define Vector_copy(__vec_ptr__) ({                                                                                                        \
-        assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                                                            \
-        __Vector_Header *__old_vec__ = __vector_get_header((__vec_ptr__));                                                                     \
-        __Vector_Header *__new_vec__ = (__Vector_Header *)malloc(sizeof(__Vector_Header) + __old_vec__->capacity * __old_vec__->element_size); \
-        assertf(__new_vec__ != NULL, "ERROR: Allocation failed\n");                                                                            \
-        memcpy(__new_vec__, __old_vec__, sizeof(__Vector_Header) + __old_vec__->length * __old_vec__->element_size);                           \
-        (void*)__new_vec__->data;                                                                                                              \
+    #define Vector_copy(__vec_ptr__) ({                             \
+        assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n"); \
+        __vector_copy((__vec_ptr__));                               \
     })
 #else // COMPILER_SUPPORTS_STATEMENT_EXPRESSIONS
     /**
      * Public
      * 
-     * Returns a shallow copy of the vector
+     * Returns a shallow copy of the vector, the copy uses the allocator of the vector
      * @param __old_vec_ptr__ [T**]    - A reference to the vector
      * @param __new_vec_ptr__ [T**]    - A reference to the copied vector
      * @throw                 [assert] - If the reference to the vector is NULL
      * @throw                 [assert] - If the vector is NULL
-     * @throw                 [assert] - If malloc fails
+     * @throw                 [assert] - If the allocation fails
      * @note the returned result is a shallow copy, if the vector contains pointers to objects, the objects will not be copied
      */
-    #define Vector_copy(__old_vec_ptr__, __new_vec_ptr__) do {                                                                                 \
-        assertf(*(__old_vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                                                        \
-        __Vector_Header *__old_vec__ = __vector_get_header((__old_vec_ptr__));                                                                 \
-        __Vector_Header *__new_vec__ = (__Vector_Header *)malloc(sizeof(__Vector_Header) + __old_vec__->capacity * __old_vec__->element_size); \
-        assertf(__new_vec__ != NULL, "ERROR: Allocation failed\n");                                                                            \
-        memcpy(__new_vec__, __old_vec__, sizeof(__Vector_Header) + __old_vec__->length * __old_vec__->element_size);                           \
-        (*(__new_vec_ptr__)) = (void*)__new_vec__->data;                                                                                       \
+    #define Vector_copy(__old_vec_ptr__, __new_vec_ptr__) do {          \
+        assertf(*(__old_vec_ptr__) != NULL, "ERROR: Vector is NULL\n"); \
+        (*(__new_vec_ptr__)) = __vector_copy((__old_vec_ptr__));        \
     } while (0)
 #endif // COMPILER_SUPPORTS_STATEMENT_EXPRESSIONS
 
@@ -769,121 +1976,402 @@ void Vector_set_calculate_optimal_capacity_fn(void *vec_ptr, Vector_calculate_op
     } while (0)
 #endif // COMPILER_SUPPORTS_TYPEOF
 
-#if COMPILER_SUPPORTS_TYPEOF
-    #define __merge__(__arr__, __left_size__, __mid__, __right_size__, __ordering_comparator__) do { \
-        int __i__, __j__, __k__;                                                                     \
-        int __n1__ = (__mid__) - (__left_size__) + 1;                                                \
-        int __n2__ =  (__right_size__) - (__mid__);                                                  \
-        typeof(*(__arr__)) *__left_array__ = (typeof(__arr__))malloc(__n1__ * sizeof(*(__arr__)));   \
-        typeof(*(__arr__)) *__right_array__ = (typeof(__arr__))malloc(__n2__ * sizeof(*(__arr__)));  \
-        for (__i__ = 0; __i__ < __n1__; __i__++) {                                                   \
-            __left_array__[__i__] = (__arr__)[(__left_size__) + __i__];                              \
-        }                                                                                            \
-        for (__j__ = 0; __j__ < __n2__; __j__++) {                                                   \
-            __right_array__[__j__] = (__arr__)[(__mid__) + 1 + __j__];                               \
-        }                                                                                            \
-        __i__ = 0; __j__ = 0; __k__ = (__left_size__);                                               \
-        while (__i__ < __n1__ && __j__ < __n2__) {                                                   \
-            if ((__ordering_comparator__)(__left_array__[__i__], __right_array__[__j__]) <= 0) {     \
-                (__arr__)[__k__++] = __left_array__[__i__++];                                        \
-            } else {                                                                                 \
-                (__arr__)[__k__++] = __right_array__[__j__++];                                       \
-            }                                                                                        \
-        }                                                                                            \
-        while (__i__ < __n1__) {                                                                     \
-            (__arr__)[__k__++] = __left_array__[__i__++];                                            \
-        }                                                                                            \
-        while (__j__ < __n2__) {                                                                     \
-            (__arr__)[__k__++] = __right_array__[__j__++];                                           \
-        }                                                                                            \
-        free(__left_array__);                                                                        \
-        free(__right_array__);                                                                       \
-    } while(0)
-
-    #define __merge_sort__(__arr__, __n__, __ordering_comparator__) do {                                                                 \
-        int __curr_size__, __left_start__;                                                                                               \
-        for (__curr_size__ = 1; __curr_size__ <= (__n__) - 1; __curr_size__ = 2 * __curr_size__) {                                       \
-            for (__left_start__ = 0; __left_start__ < (__n__) - 1; __left_start__ += 2 * __curr_size__) {                                \
-                int __mid__ = __left_start__ + __curr_size__ < (__n__) ? __left_start__ + __curr_size__ - 1 : (__n__) - 1;               \
-                int __right_end__ = __left_start__ + 2 * __curr_size__ < (__n__) ? __left_start__ + 2 * __curr_size__ - 1 : (__n__) - 1; \
-                __merge__((__arr__), __left_start__, __mid__, __right_end__, (__ordering_comparator__));                                 \
-            }                                                                                                                            \
-        }                                                                                                                                \
-    } while(0)
+// a merge switches to galloping once one side has won this many comparisons in a row
+#define __VECTOR_MIN_GALLOP 7
+
+/**
+ * Internal
+ * 
+ * Finds with an exponential then a binary search the first index in [0, __len__) for which __found__ holds (__len__ if none),
+ * __found__ must be false then true along the range, it is an expression of the index `__probe__`
+ * @param __result__ [size_t]     - The variable receiving the index
+ * @param __len__    [size_t]     - The length of the range
+ * @param __probe__  [identifier] - The name of the index __found__ uses
+ * @param __found__  [bool]       - The expression to evaluate at an index
+ */
+#define __gallop__(__result__, __len__, __probe__, __found__) do {                             \
+    size_t __gallop_lo__ = 0, __gallop_step__ = 1, __gallop_hi__, __probe__;                   \
+    for (;;) {                                                                                 \
+        if (__gallop_lo__ + __gallop_step__ > (__len__)) { __gallop_hi__ = (__len__); break; } \
+        __probe__ = __gallop_lo__ + __gallop_step__ - 1;                                       \
+        if (__found__) { __gallop_hi__ = __probe__; break; }                                   \
+        __gallop_lo__ = __probe__ + 1;                                                         \
+        __gallop_step__ <<= 1;                                                                 \
+    }                                                                                          \
+    while (__gallop_lo__ < __gallop_hi__) {                                                    \
+        __probe__ = __gallop_lo__ + (__gallop_hi__ - __gallop_lo__) / 2;                       \
+        if (__found__) { __gallop_hi__ = __probe__; } else { __gallop_lo__ = __probe__ + 1; }  \
+    }                                                                                          \
+    (__result__) = __gallop_lo__;                                                              \
+} while (0)
+
+/**
+ * Internal
+ * 
+ * Sorts an array in place with a stable adaptive merge sort (timsort):
+ * the array is cut in natural runs (strictly descending ones are reversed), runs shorter than a minimum run length of 32 to 64 are extended with an insertion sort,
+ * and the runs are merged as they are found, keeping the lengths on the run stack balanced
+ * A merge first skips the elements already in place, copies the shorter run to a scratch buffer and switches to galloping (bulk moves) when one side keeps winning
+ * The scratch buffer, of n / 2 elements, is allocated once from the allocator at the first merge: a sorted array is checked in O(n) without any allocation
+ * @param __arr__                 [T*]                - The array
+ * @param __n__                   [size_t]            - The number of elements
+ * @param __ordering_comparator__ [int (*)(T, T)]     - The ordering comparator function
+ * @param __allocator__           [Vector_Allocator*] - The allocator of the scratch buffer
+ * @param __element_type__        [type]              - The type of the elements
+ * @throw                         [assert]            - If the allocation fails
+ */
+#define __timsort__(__arr__, __n__, __ordering_comparator__, __allocator__, __element_type__) do {                                                                                                      \
+    size_t __length__ = (__n__);                                                                                                                                                                        \
+    size_t __min_run__ = __length__, __odd__ = 0;                                                                                                                                                       \
+    while (__min_run__ >= 64) { __odd__ |= __min_run__ & 1; __min_run__ >>= 1; }                                                                                                                        \
+    __min_run__ += __odd__;                                                                                                                                                                             \
+    size_t __run_base__[128], __run_len__[128];                                                                                                                                                         \
+    size_t __runs__ = 0, __next__ = 0;                                                                                                                                                                  \
+    __element_type__ *__scratch__ = NULL;                                                                                                                                                               \
+    size_t __scratch_size__ = (__length__ / 2) * sizeof(__element_type__);                                                                                                                              \
+    __element_type__ __temp__;                                                                                                                                                                          \
+    for (;;) {                                                                                                                                                                                          \
+        /* the runs to merge: with input left, the top runs unless the stack is balanced; without, all of them */                                                                                       \
+        size_t __at__ = 0;                                                                                                                                                                              \
+        bool __merging__ = false;                                                                                                                                                                       \
+        if (__runs__ > 1) {                                                                                                                                                                             \
+            __at__ = __runs__ - 2;                                                                                                                                                                      \
+            if ((__at__ > 0 && __run_len__[__at__ - 1] <= __run_len__[__at__] + __run_len__[__at__ + 1]) || (__at__ > 1 && __run_len__[__at__ - 2] <= __run_len__[__at__ - 1] + __run_len__[__at__])) { \
+                if (__run_len__[__at__ - 1] < __run_len__[__at__ + 1]) { __at__--; }                                                                                                                    \
+                __merging__ = true;                                                                                                                                                                     \
+            } else if (__run_len__[__at__] <= __run_len__[__at__ + 1] || __next__ == __length__) {                                                                                                      \
+                if (__next__ == __length__ && __at__ > 0 && __run_len__[__at__ - 1] < __run_len__[__at__ + 1]) { __at__--; }                                                                            \
+                __merging__ = true;                                                                                                                                                                     \
+            }                                                                                                                                                                                           \
+        }                                                                                                                                                                                               \
+        if (__merging__) {                                                                                                                                                                              \
+            size_t __base1__ = __run_base__[__at__], __len1__ = __run_len__[__at__];                                                                                                                    \
+            size_t __base2__ = __run_base__[__at__ + 1], __len2__ = __run_len__[__at__ + 1];                                                                                                            \
+            __run_len__[__at__] = __len1__ + __len2__;                                                                                                                                                  \
+            if (__at__ + 2 < __runs__) { __run_base__[__at__ + 1] = __run_base__[__at__ + 2]; __run_len__[__at__ + 1] = __run_len__[__at__ + 2]; }                                                      \
+            __runs__--;                                                                                                                                                                                 \
+            /* the start of the first run not greater than the first element of the second run, and the end of the second run not smaller than the last element of the first one, are in place */       \
+            size_t __skip__;                                                                                                                                                                            \
+            __gallop__(__skip__, __len1__, __probe__, (__ordering_comparator__)((__arr__)[__base2__], (__arr__)[__base1__ + __probe__]) < 0);                                                           \
+            __base1__ += __skip__;                                                                                                                                                                      \
+            __len1__ -= __skip__;                                                                                                                                                                       \
+            if (__len1__ == 0) { continue; }                                                                                                                                                            \
+            __gallop__(__len2__, __len2__, __probe__, !((__ordering_comparator__)((__arr__)[__base2__ + __probe__], (__arr__)[__base1__ + __len1__ - 1]) < 0));                                         \
+            if (__len2__ == 0) { continue; }                                                                                                                                                            \
+            if (__scratch__ == NULL) {                                                                                                                                                                  \
+                __scratch__ = (__element_type__ *)__vector_allocator_alloc((__allocator__), __scratch_size__);                                                                                          \
+                assertf(__scratch__ != NULL, "ERROR: Could not allocate the sort buffer\n");                                                                                                            \
+            }                                                                                                                                                                                           \
+            size_t __wins1__ = 0, __wins2__ = 0, __count__;                                                                                                                                             \
+            if (__len1__ <= __len2__) {                                                                                                                                                                 \
+                /* the first run goes to the scratch buffer, the merge fills the array from the front */                                                                                                \
+                memcpy(__scratch__, (__arr__) + __base1__, __len1__ * sizeof(__element_type__));                                                                                                        \
+                size_t __i__ = 0, __j__ = __base2__, __k__ = __base1__, __end__ = __base2__ + __len2__;                                                                                                 \
+                while (__i__ < __len1__ && __j__ < __end__) {                                                                                                                                           \
+                    if ((__ordering_comparator__)((__arr__)[__j__], __scratch__[__i__]) < 0) { (__arr__)[__k__++] = (__arr__)[__j__++]; __wins2__++; __wins1__ = 0; }                                   \
+                    else { (__arr__)[__k__++] = __scratch__[__i__++]; __wins1__++; __wins2__ = 0; }                                                                                                     \
+                    if (__wins1__ >= __VECTOR_MIN_GALLOP && __i__ < __len1__ && __j__ < __end__) {                                                                                                      \
+                        __gallop__(__count__, __len1__ - __i__, __probe__, (__ordering_comparator__)((__arr__)[__j__], __scratch__[__i__ + __probe__]) < 0);                                            \
+                        memcpy((__arr__) + __k__, __scratch__ + __i__, __count__ * sizeof(__element_type__));                                                                                           \
+                        __i__ += __count__; __k__ += __count__; __wins1__ = 0;                                                                                                                          \
+                    } else if (__wins2__ >= __VECTOR_MIN_GALLOP && __i__ < __len1__ && __j__ < __end__) {                                                                                               \
+                        __gallop__(__count__, __end__ - __j__, __probe__, !((__ordering_comparator__)((__arr__)[__j__ + __probe__], __scratch__[__i__]) < 0));                                          \
+                        memmove((__arr__) + __k__, (__arr__) + __j__, __count__ * sizeof(__element_type__));                                                                                            \
+                        __j__ += __count__; __k__ += __count__; __wins2__ = 0;                                                                                                                          \
+                    }                                                                                                                                                                                   \
+                }                                                                                                                                                                                       \
+                memcpy((__arr__) + __k__, __scratch__ + __i__, (__len1__ - __i__) * sizeof(__element_type__));                                                                                          \
+            } else {                                                                                                                                                                                    \
+                /* the second run goes to the scratch buffer, the merge fills the array from the back */                                                                                                \
+                memcpy(__scratch__, (__arr__) + __base2__, __len2__ * sizeof(__element_type__));                                                                                                        \
+                size_t __i__ = __base1__ + __len1__, __j__ = __len2__, __k__ = __base2__ + __len2__;                                                                                                    \
+                while (__i__ > __base1__ && __j__ > 0) {                                                                                                                                                \
+                    if ((__ordering_comparator__)(__scratch__[__j__ - 1], (__arr__)[__i__ - 1]) < 0) { (__arr__)[--__k__] = (__arr__)[--__i__]; __wins1__++; __wins2__ = 0; }                           \
+                    else { (__arr__)[--__k__] = __scratch__[--__j__]; __wins2__++; __wins1__ = 0; }                                                                                                     \
+                    if (__wins1__ >= __VECTOR_MIN_GALLOP && __i__ > __base1__ && __j__ > 0) {                                                                                                           \
+                        __gallop__(__count__, __i__ - __base1__, __probe__, (__ordering_comparator__)(__scratch__[__j__ - 1], (__arr__)[__base1__ + __probe__]) < 0);                                   \
+                        __count__ = __i__ - __base1__ - __count__;                                                                                                                                      \
+                        __i__ -= __count__; __k__ -= __count__;                                                                                                                                         \
+                        memmove((__arr__) + __k__, (__arr__) + __i__, __count__ * sizeof(__element_type__));                                                                                            \
+                        __wins1__ = 0;                                                                                                                                                                  \
+                    } else if (__wins2__ >= __VECTOR_MIN_GALLOP && __i__ > __base1__ && __j__ > 0) {                                                                                                    \
+                        __gallop__(__count__, __j__, __probe__, !((__ordering_comparator__)(__scratch__[__probe__], (__arr__)[__i__ - 1]) < 0));                                                        \
+                        __count__ = __j__ - __count__;                                                                                                                                                  \
+                        __j__ -= __count__; __k__ -= __count__;                                                                                                                                         \
+                        memcpy((__arr__) + __k__, __scratch__ + __j__, __count__ * sizeof(__element_type__));                                                                                           \
+                        __wins2__ = 0;                                                                                                                                                                  \
+                    }                                                                                                                                                                                   \
+                }                                                                                                                                                                                       \
+                memcpy((__arr__) + __k__ - __j__, __scratch__, __j__ * sizeof(__element_type__));                                                                                                       \
+            }                                                                                                                                                                                           \
+            continue;                                                                                                                                                                                   \
+        }                                                                                                                                                                                               \
+        if (__next__ == __length__) { break; }                                                                                                                                                          \
+        /* the next natural run, extended to the minimum run length */                                                                                                                                  \
+        size_t __lo__ = __next__, __hi__ = __next__ + 1;                                                                                                                                                \
+        if (__hi__ < __length__) {                                                                                                                                                                      \
+            if ((__ordering_comparator__)((__arr__)[__hi__], (__arr__)[__lo__]) < 0) {                                                                                                                  \
+                while (__hi__ < __length__ && (__ordering_comparator__)((__arr__)[__hi__], (__arr__)[__hi__ - 1]) < 0) { __hi__++; }                                                                    \
+                for (size_t __a__ = __lo__, __b__ = __hi__ - 1; __a__ < __b__; __a__++, __b__--) { __temp__ = (__arr__)[__a__]; (__arr__)[__a__] = (__arr__)[__b__]; (__arr__)[__b__] = __temp__; }     \
+            } else {                                                                                                                                                                                    \
+                while (__hi__ < __length__ && !((__ordering_comparator__)((__arr__)[__hi__], (__arr__)[__hi__ - 1]) < 0)) { __hi__++; }                                                                 \
+            }                                                                                                                                                                                           \
+        }                                                                                                                                                                                               \
+        size_t __run_end__ = __length__ - __lo__ < __min_run__ ? __length__ : __lo__ + __min_run__;                                                                                                     \
+        for (; __hi__ < __run_end__; __hi__++) {                                                                                                                                                        \
+            __temp__ = (__arr__)[__hi__];                                                                                                                                                               \
+            size_t __j__ = __hi__;                                                                                                                                                                      \
+            while (__j__ > __lo__ && (__ordering_comparator__)(__temp__, (__arr__)[__j__ - 1]) < 0) { (__arr__)[__j__] = (__arr__)[__j__ - 1]; __j__--; }                                               \
+            (__arr__)[__j__] = __temp__;                                                                                                                                                                \
+        }                                                                                                                                                                                               \
+        __run_base__[__runs__] = __lo__;                                                                                                                                                                \
+        __run_len__[__runs__++] = __hi__ - __lo__;                                                                                                                                                      \
+        __next__ = __hi__;                                                                                                                                                                              \
+    }                                                                                                                                                                                                   \
+    if (__scratch__ != NULL) { __vector_allocator_free((__allocator__), __scratch__, __scratch_size__); }                                                                                               \
+} while (0)
 
+#if COMPILER_SUPPORTS_TYPEOF
     /**
      * Public
      * 
-     * Sorts the vector in place
+     * Sorts the vector in place, equal values keep their order (timsort: the runs already sorted are kept, a sorted vector takes a single pass and no allocation)
      * @param __vec_ptr__             [T**]           - A reference to the vector
      * @param __ordering_comparator__ [int (*)(T, T)] - The ordering comparator function to compare the values, should return a positive number if the first value is greater than the second value, a negative number if the first value is less than the second value, and 0 if the values are equal
      * @throw                         [assert]        - If the reference to the vector is NULL
      * @throw                         [assert]        - If the vector is NULL
+     * @throw                         [assert]        - If the allocation of the scratch buffer (n / 2 elements) fails
      */
-    #define Vector_sort(__vec_ptr__, __ordering_comparator__) do {                       \
-        assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                      \
-        __Vector_Header *__header__ = __vector_get_header((__vec_ptr__));                \
-        __merge_sort__((*(__vec_ptr__)), __header__->length, (__ordering_comparator__)); \
+    #define Vector_sort(__vec_ptr__, __ordering_comparator__) do {                                                                                                                \
+        assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                                                                                               \
+        __Vector_Header *__header__ = __vector_get_header((__vec_ptr__));                                                                                                         \
+        __timsort__((*(__vec_ptr__)), __header__->length, (__ordering_comparator__), __vector_derived_allocator(__VECTOR_TRAIT(__header__, allocator)), typeof(**(__vec_ptr__))); \
     } while (0)
 #else // COMPILER_SUPPORTS_TYPEOF
-    #define __merge__(__arr__, __left_size__, __mid__, __right_size__, __ordering_comparator__, __vec_element_type__) do { \
-        int __i__, __j__, __k__;                                                                                           \
-        int __n1__ = (__mid__) - (__left_size__) + 1;                                                                      \
-        int __n2__ =  (__right_size__) - (__mid__);                                                                        \
-        __vec_element_type__ *__left_array__ = (__vec_element_type__ *)malloc(__n1__ * sizeof(*(__arr__)));                \
-        __vec_element_type__ *__right_array__ = (__vec_element_type__ *)malloc(__n2__ * sizeof(*(__arr__)));               \
-        for (__i__ = 0; __i__ < __n1__; __i__++) {                                                                         \
-            __left_array__[__i__] = (__arr__)[(__left_size__) + __i__];                                                    \
-        }                                                                                                                  \
-        for (__j__ = 0; __j__ < __n2__; __j__++) {                                                                         \
-            __right_array__[__j__] = (__arr__)[(__mid__) + 1 + __j__];                                                     \
-        }                                                                                                                  \
-        __i__ = 0; __j__ = 0; __k__ = (__left_size__);                                                                     \
-        while (__i__ < __n1__ && __j__ < __n2__) {                                                                         \
-            if ((__ordering_comparator__)(__left_array__[__i__], __right_array__[__j__]) <= 0) {                           \
-                (__arr__)[__k__++] = __left_array__[__i__++];                                                              \
-            } else {                                                                                                       \
-                (__arr__)[__k__++] = __right_array__[__j__++];                                                             \
-            }                                                                                                              \
-        }                                                                                                                  \
-        while (__i__ < __n1__) {                                                                                           \
-            (__arr__)[__k__++] = __left_array__[__i__++];                                                                  \
-        }                                                                                                                  \
-        while (__j__ < __n2__) {                                                                                           \
-            (__arr__)[__k__++] = __right_array__[__j__++];                                                                 \
-        }                                                                                                                  \
-        free(__left_array__);                                                                                              \
-        free(__right_array__);                                                                                             \
-    } while(0)
-
-    #define __merge_sort__(__arr__, __n__, __ordering_comparator__, __vec_element_type__) do {                                           \
-        int __curr_size__, __left_start__;                                                                                               \
-        for (__curr_size__ = 1; __curr_size__ <= (__n__) - 1; __curr_size__ = 2 * __curr_size__) {                                       \
-            for (__left_start__ = 0; __left_start__ < (__n__) - 1; __left_start__ += 2 * __curr_size__) {                                \
-                int __mid__ = __left_start__ + __curr_size__ < (__n__) ? __left_start__ + __curr_size__ - 1 : (__n__) - 1;               \
-                int __right_end__ = __left_start__ + 2 * __curr_size__ < (__n__) ? __left_start__ + 2 * __curr_size__ - 1 : (__n__) - 1; \
-                __merge__((__arr__), __left_start__, __mid__, __right_end__, (__ordering_comparator__), __vec_element_type__);           \
-            }                                                                                                                            \
-        }                                                                                                                                \
-    } while(0)
+    /**
+     * Public
+     * 
+     * Sorts the vector in place, equal values keep their order (timsort: the runs already sorted are kept, a sorted vector takes a single pass and no allocation)
+     * @param __vec_ptr__             [T**]           - A reference to the vector
+     * @param __ordering_comparator__ [int (*)(T, T)] - The ordering comparator function to compare the values, should return a positive number if the first value is greater than the second value, a negative number if the first value is less than the second value, and 0 if the values are equal
+     * @param __vec_element_type__    [type]          - The type of the elements in the vector
+     * @throw                         [assert]        - If the reference to the vector is NULL
+     * @throw                         [assert]        - If the vector is NULL
+     * @throw                         [assert]        - If the allocation of the scratch buffer (n / 2 elements) fails
+     */
+    #define Vector_sort(__vec_ptr__, __ordering_comparator__, __vec_element_type__) do {                                                                                       \
+        assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                                                                                            \
+        __Vector_Header *__header__ = __vector_get_header((__vec_ptr__));                                                                                                      \
+        __timsort__((*(__vec_ptr__)), __header__->length, (__ordering_comparator__), __vector_derived_allocator(__VECTOR_TRAIT(__header__, allocator)), __vec_element_type__); \
+    } while (0)
+#endif // COMPILER_SUPPORTS_TYPEOF
+
+// the ranges Vector_sort_unstable sorts with an insertion sort
+#define __VECTOR_INSERTION_SORT_THRESHOLD 16
+// the ranges above this size take the median of three medians of three as their pivot, the smaller ones the median of three
+#define __VECTOR_NINTHER_THRESHOLD 128
+
+/**
+ * Internal
+ * 
+ * Orders three elements of an array with the comparator
+ * @param __arr__                 [T*]            - The array
+ * @param __a__                   [size_t]        - The index of the first element
+ * @param __b__                   [size_t]        - The index of the second element
+ * @param __c__                   [size_t]        - The index of the third element
+ * @param __ordering_comparator__ [int (*)(T, T)] - The ordering comparator function
+ * @param __temp__                [T]             - A variable to swap through
+ */
+#define __sort3__(__arr__, __a__, __b__, __c__, __ordering_comparator__, __temp__) do {                                                                                                       \
+    if ((__ordering_comparator__)((__arr__)[(__b__)], (__arr__)[(__a__)]) < 0) { (__temp__) = (__arr__)[(__a__)]; (__arr__)[(__a__)] = (__arr__)[(__b__)]; (__arr__)[(__b__)] = (__temp__); } \
+    if ((__ordering_comparator__)((__arr__)[(__c__)], (__arr__)[(__b__)]) < 0) { (__temp__) = (__arr__)[(__b__)]; (__arr__)[(__b__)] = (__arr__)[(__c__)]; (__arr__)[(__c__)] = (__temp__); } \
+    if ((__ordering_comparator__)((__arr__)[(__b__)], (__arr__)[(__a__)]) < 0) { (__temp__) = (__arr__)[(__a__)]; (__arr__)[(__a__)] = (__arr__)[(__b__)]; (__arr__)[(__b__)] = (__temp__); } \
+} while (0)
+
+/**
+ * Internal
+ * 
+ * Moves the element at `__root__` down the max heap of the `__n__` first elements of `__base__`
+ * @param __base__                [T*]            - The heap
+ * @param __root__                [size_t]        - The index of the element to move down
+ * @param __n__                   [size_t]        - The size of the heap
+ * @param __ordering_comparator__ [int (*)(T, T)] - The ordering comparator function
+ * @param __temp__                [T]             - A variable to hold the element
+ */
+#define __heap_sift_down__(__base__, __root__, __n__, __ordering_comparator__, __temp__) do {                                            \
+    size_t __node__ = (__root__);                                                                                                        \
+    (__temp__) = (__base__)[__node__];                                                                                                   \
+    for (;;) {                                                                                                                           \
+        size_t __child__ = 2 * __node__ + 1;                                                                                             \
+        if (__child__ >= (__n__)) { break; }                                                                                             \
+        if (__child__ + 1 < (__n__) && (__ordering_comparator__)((__base__)[__child__], (__base__)[__child__ + 1]) < 0) { __child__++; } \
+        if (!((__ordering_comparator__)((__temp__), (__base__)[__child__]) < 0)) { break; }                                              \
+        (__base__)[__node__] = (__base__)[__child__];                                                                                    \
+        __node__ = __child__;                                                                                                            \
+    }                                                                                                                                    \
+    (__base__)[__node__] = (__temp__);                                                                                                   \
+} while (0)
+
+/**
+ * Internal
+ * 
+ * Sorts an array in place with an introsort, nothing is allocated and the order of equal elements is not kept:
+ * quicksort partitions around a median of three (of medians of three for big ranges), ranges of at most __VECTOR_INSERTION_SORT_THRESHOLD elements are insertion sorted,
+ * and a range still being partitioned after 2 * log2(n) levels is heap sorted, so the worst case stays O(n log n)
+ * The pending ranges live on a fixed stack: the bigger side of a partition is pushed, the smaller one is sorted first, so there are never more than log2(n) of them
+ * @param __arr__                 [T*]            - The array
+ * @param __n__                   [size_t]        - The number of elements
+ * @param __ordering_comparator__ [int (*)(T, T)] - The ordering comparator function
+ * @param __element_type__        [type]          - The type of the elements
+ */
+#define __introsort__(__arr__, __n__, __ordering_comparator__, __element_type__) do {                                         \
+    size_t __stack_lo__[64], __stack_hi__[64], __stack_depth__[64];                                                           \
+    size_t __top__ = 0;                                                                                                       \
+    size_t __lo__ = 0, __hi__ = (__n__);                                                                                      \
+    size_t __depth__ = 0;                                                                                                     \
+    for (size_t __m__ = __hi__; __m__ > 1; __m__ >>= 1) { __depth__ += 2; }                                                   \
+    __element_type__ __temp__;                                                                                                \
+    for (;;) {                                                                                                                \
+        size_t __len__ = __hi__ - __lo__;                                                                                     \
+        if (__len__ <= __VECTOR_INSERTION_SORT_THRESHOLD) {                                                                   \
+            for (size_t __i__ = __lo__ + 1; __i__ < __hi__; __i__++) {                                                        \
+                __temp__ = (__arr__)[__i__];                                                                                  \
+                size_t __j__ = __i__;                                                                                         \
+                while (__j__ > __lo__ && (__ordering_comparator__)(__temp__, (__arr__)[__j__ - 1]) < 0) {                     \
+                    (__arr__)[__j__] = (__arr__)[__j__ - 1];                                                                  \
+                    __j__--;                                                                                                  \
+                }                                                                                                             \
+                (__arr__)[__j__] = __temp__;                                                                                  \
+            }                                                                                                                 \
+        } else if (__depth__ == 0) {                                                                                          \
+            for (size_t __i__ = __len__ / 2; __i__-- > 0;) {                                                                  \
+                __heap_sift_down__((__arr__) + __lo__, __i__, __len__, (__ordering_comparator__), __temp__);                  \
+            }                                                                                                                 \
+            for (size_t __end__ = __len__ - 1; __end__ > 0; __end__--) {                                                      \
+                __temp__ = (__arr__)[__lo__ + __end__];                                                                       \
+                (__arr__)[__lo__ + __end__] = (__arr__)[__lo__];                                                              \
+                (__arr__)[__lo__] = __temp__;                                                                                 \
+                __heap_sift_down__((__arr__) + __lo__, 0, __end__, (__ordering_comparator__), __temp__);                      \
+            }                                                                                                                 \
+        } else {                                                                                                              \
+            __depth__--;                                                                                                      \
+            size_t __mid__ = __lo__ + __len__ / 2;                                                                            \
+            if (__len__ > __VECTOR_NINTHER_THRESHOLD) {                                                                       \
+                __sort3__((__arr__), __lo__, __mid__, __hi__ - 1, (__ordering_comparator__), __temp__);                       \
+                __sort3__((__arr__), __lo__ + 1, __mid__ - 1, __hi__ - 2, (__ordering_comparator__), __temp__);               \
+                __sort3__((__arr__), __lo__ + 2, __mid__ + 1, __hi__ - 3, (__ordering_comparator__), __temp__);               \
+                __sort3__((__arr__), __mid__ - 1, __mid__, __mid__ + 1, (__ordering_comparator__), __temp__);                 \
+            } else {                                                                                                          \
+                __sort3__((__arr__), __lo__, __mid__, __hi__ - 1, (__ordering_comparator__), __temp__);                       \
+            }                                                                                                                 \
+            /* the pivot goes first and stays there while the rest is partitioned, equal elements stop both scans */          \
+            __temp__ = (__arr__)[__lo__]; (__arr__)[__lo__] = (__arr__)[__mid__]; (__arr__)[__mid__] = __temp__;              \
+            size_t __i__ = __lo__, __j__ = __hi__;                                                                            \
+            for (;;) {                                                                                                        \
+                do { __i__++; } while (__i__ < __hi__ && (__ordering_comparator__)((__arr__)[__i__], (__arr__)[__lo__]) < 0); \
+                do { __j__--; } while ((__ordering_comparator__)((__arr__)[__lo__], (__arr__)[__j__]) < 0);                   \
+                if (__i__ >= __j__) { break; }                                                                                \
+                __temp__ = (__arr__)[__i__]; (__arr__)[__i__] = (__arr__)[__j__]; (__arr__)[__j__] = __temp__;                \
+            }                                                                                                                 \
+            __temp__ = (__arr__)[__lo__]; (__arr__)[__lo__] = (__arr__)[__j__]; (__arr__)[__j__] = __temp__;                  \
+            /* [lo, j) and [j + 1, hi) are left, the bigger one waits on the stack */                                         \
+            if (__j__ - __lo__ < __hi__ - __j__ - 1) {                                                                        \
+                __stack_lo__[__top__] = __j__ + 1; __stack_hi__[__top__] = __hi__; __stack_depth__[__top__++] = __depth__;    \
+                __hi__ = __j__;                                                                                               \
+            } else {                                                                                                          \
+                __stack_lo__[__top__] = __lo__; __stack_hi__[__top__] = __j__; __stack_depth__[__top__++] = __depth__;        \
+                __lo__ = __j__ + 1;                                                                                           \
+            }                                                                                                                 \
+            continue;                                                                                                         \
+        }                                                                                                                     \
+        if (__top__ == 0) { break; }                                                                                          \
+        __top__--;                                                                                                            \
+        __lo__ = __stack_lo__[__top__]; __hi__ = __stack_hi__[__top__]; __depth__ = __stack_depth__[__top__];                 \
+    }                                                                                                                         \
+} while (0)
 
+#if COMPILER_SUPPORTS_TYPEOF
+    /**
+     * Public
+     * 
+     * Sorts the vector in place without allocating anything, faster than Vector_sort but equal values may not keep their order (introsort)
+     * @param __vec_ptr__             [T**]           - A reference to the vector
+     * @param __ordering_comparator__ [int (*)(T, T)] - The ordering comparator function to compare the values, should return a positive number if the first value is greater than the second value, a negative number if the first value is less than the second value, and 0 if the values are equal
+     * @throw                         [assert]        - If the reference to the vector is NULL
+     * @throw                         [assert]        - If the vector is NULL
+     */
+    #define Vector_sort_unstable(__vec_ptr__, __ordering_comparator__) do {                                                    \
+        assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                                            \
+        __introsort__((*(__vec_ptr__)), Vector_get_length((__vec_ptr__)), (__ordering_comparator__), typeof(**(__vec_ptr__))); \
+    } while (0)
+#else // COMPILER_SUPPORTS_TYPEOF
     /**
      * Public
      * 
-     * Sorts the vector in place
+     * Sorts the vector in place without allocating anything, faster than Vector_sort but equal values may not keep their order (introsort)
      * @param __vec_ptr__             [T**]           - A reference to the vector
      * @param __ordering_comparator__ [int (*)(T, T)] - The ordering comparator function to compare the values, should return a positive number if the first value is greater than the second value, a negative number if the first value is less than the second value, and 0 if the values are equal
      * @param __vec_element_type__    [type]          - The type of the elements in the vector
      * @throw                         [assert]        - If the reference to the vector is NULL
      * @throw                         [assert]        - If the vector is NULL
      */
-    #define Vector_sort(__vec_ptr__, __ordering_comparator__, __vec_element_type__) do {                       \
-        assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                            \
-        __Vector_Header *__header__ = __vector_get_header((__vec_ptr__));                                      \
-        __merge_sort__((*(__vec_ptr__)), __header__->length, (__ordering_comparator__), __vec_element_type__); \
+    #define Vector_sort_unstable(__vec_ptr__, __ordering_comparator__, __vec_element_type__) do {                           \
+        assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                                         \
+        __introsort__((*(__vec_ptr__)), Vector_get_length((__vec_ptr__)), (__ordering_comparator__), __vec_element_type__); \
     } while (0)
 #endif // COMPILER_SUPPORTS_TYPEOF
 
+#if VECTOR_FILTER_COUNT_FIRST
+    /**
+     * Internal
+     * 
+     * Stores in `__capacity__` the number of elements passing the filter, the exact capacity of the filtered vector
+     * @param __vec_ptr__  [T**]         - A reference to the vector
+     * @param __filter__   [bool (*)(T)] - The filter function
+     * @param __capacity__ [size_t]      - The variable receiving the capacity
+     */
+    #define __vector_filter_capacity__(__vec_ptr__, __filter__, __capacity__) do {  \
+        (__capacity__) = 0;                                                         \
+        for (size_t __i__ = 0; __i__ < Vector_get_length((__vec_ptr__)); __i__++) { \
+            if ((__filter__)((*(__vec_ptr__))[__i__])) { (__capacity__)++; }        \
+        }                                                                           \
+    } while (0)
+#else // VECTOR_FILTER_COUNT_FIRST
+    /**
+     * Internal
+     * 
+     * Stores in `__capacity__` the length of the vector, the upper bound of the length of the filtered vector
+     * @param __vec_ptr__  [T**]         - A reference to the vector
+     * @param __filter__   [bool (*)(T)] - The filter function (unused)
+     * @param __capacity__ [size_t]      - The variable receiving the capacity
+     */
+    #define __vector_filter_capacity__(__vec_ptr__, __filter__, __capacity__) do { \
+        (__capacity__) = Vector_get_length((__vec_ptr__));                         \
+    } while (0)
+#endif // VECTOR_FILTER_COUNT_FIRST
+
+/**
+ * Internal
+ * 
+ * Copies the elements passing the filter into an empty vector presized by __vector_filter_capacity__, without a resize check per element,
+ * then trims the capacity once to exactly the number of elements kept if it was over-allocated, like the exact capacity of Vector_slice and Vector_map
+ * @param __vec_ptr__     [T**]         - A reference to the vector
+ * @param __filter__      [bool (*)(T)] - The filter function
+ * @param __new_vec_ptr__ [T**]         - A reference to the filtered vector
+ */
+#define __vector_filter_into__(__vec_ptr__, __filter__, __new_vec_ptr__) do {              \
+    size_t __length__ = Vector_get_length((__vec_ptr__));                                  \
+    size_t __count__ = 0;                                                                  \
+    for (size_t __i__ = 0; __i__ < __length__; __i__++) {                                  \
+        if ((__filter__)((*(__vec_ptr__))[__i__])) {                                       \
+            (*(__new_vec_ptr__))[__count__++] = (*(__vec_ptr__))[__i__];                   \
+        }                                                                                  \
+    }                                                                                      \
+    __Vector_Header *__new_header__ = __vector_get_header((__new_vec_ptr__));              \
+    __new_header__->length = __count__;                                                    \
+    if (__count__ < __new_header__->capacity) { Vector_shrink_to_fit((__new_vec_ptr__)); } \
+} while (0)
+
 #if COMPILER_SUPPORTS_STATEMENT_EXPRESSIONS
     #if COMPILER_SUPPORTS_TYPEOF
         /**
@@ -897,15 +2385,13 @@ void Vector_set_calculate_optimal_capacity_fn(void *vec_ptr, Vector_calculate_op
          * @throw             [assert]      - If the vector is NULL
          * @throw             [assert]      - If malloc fails
          */
-        #define Vector_filter(__vec_ptr__, __filter__) ({                               \
-            assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                 \
-            typeof(*(__vec_ptr__)) __new_vec__ = Vector_init(typeof(**(__vec_ptr__)));  \
-            for (size_t __i__ = 0; __i__ < Vector_get_length((__vec_ptr__)); __i__++) { \
-                if ((__filter__)((*(__vec_ptr__))[__i__])) {                            \
-                    Vector_push(&__new_vec__, (*(__vec_ptr__))[__i__]);                 \
-                }                                                                       \
-            }                                                                           \
-            __new_vec__;                                                                \
+        #define Vector_filter(__vec_ptr__, __filter__) ({                                                                                          \
+            assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                                                            \
+            size_t __capacity__;                                                                                                                   \
+            __vector_filter_capacity__((__vec_ptr__), (__filter__), __capacity__);                                                                 \
+            typeof(*(__vec_ptr__)) __new_vec__ = (typeof(*(__vec_ptr__)))__vector_init_from((__vec_ptr__), sizeof(**(__vec_ptr__)), __capacity__); \
+            __vector_filter_into__((__vec_ptr__), (__filter__), &__new_vec__);                                                                     \
+            __new_vec__;                                                                                                                           \
         })
     #else // COMPILER_SUPPORTS_TYPEOF
         /**
@@ -920,15 +2406,13 @@ void Vector_set_calculate_optimal_capacity_fn(void *vec_ptr, Vector_calculate_op
          * @throw                      [assert]      - If the vector is NULL
          * @throw                      [assert]      - If malloc fails
          */
-        #define Vector_filter(__vec_ptr__, __filter__, __vec_element_type__) ({         \
-            assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                 \
-            __vec_element_type__ *__new_vec__ = Vector_init(__vec_element_type__);      \
-            for (size_t __i__ = 0; __i__ < Vector_get_length((__vec_ptr__)); __i__++) { \
-                if ((__filter__)((*(__vec_ptr__))[__i__])) {                            \
-                    Vector_push(&__new_vec__, (*(__vec_ptr__))[__i__]);                 \
-                }                                                                       \
-            }                                                                           \
-            __new_vec__;                                                                \
+        #define Vector_filter(__vec_ptr__, __filter__, __vec_element_type__) ({                                                                        \
+            assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                                                                \
+            size_t __capacity__;                                                                                                                       \
+            __vector_filter_capacity__((__vec_ptr__), (__filter__), __capacity__);                                                                     \
+            __vec_element_type__ *__new_vec__ = (__vec_element_type__ *)__vector_init_from((__vec_ptr__), sizeof(__vec_element_type__), __capacity__); \
+            __vector_filter_into__((__vec_ptr__), (__filter__), &__new_vec__);                                                                         \
+            __new_vec__;                                                                                                                               \
         })
     #endif // COMPILER_SUPPORTS_TYPEOF
 #else // COMPILER_SUPPORTS_STATEMENT_EXPRESSIONS
@@ -945,14 +2429,12 @@ void Vector_set_calculate_optimal_capacity_fn(void *vec_ptr, Vector_calculate_op
          * @throw                 [assert]      - If the reference to the new vector is NULL
          * @throw                 [assert]      - If malloc fails
          */
-        #define Vector_filter(__vec_ptr__, __filter__, __new_vec_ptr__) do {            \
-            assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                 \
-            (*(__new_vec_ptr__)) = Vector_init(typeof(**(__vec_ptr__)));                \
-            for (size_t __i__ = 0; __i__ < Vector_get_length((__vec_ptr__)); __i__++) { \
-                if ((__filter__)((*(__vec_ptr__))[__i__])) {                            \
-                    Vector_push((__new_vec_ptr__), (*(__vec_ptr__))[__i__]);            \
-                }                                                                       \
-            }                                                                           \
+        #define Vector_filter(__vec_ptr__, __filter__, __new_vec_ptr__) do {                                                         \
+            assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                                              \
+            size_t __capacity__;                                                                                                     \
+            __vector_filter_capacity__((__vec_ptr__), (__filter__), __capacity__);                                                   \
+            (*(__new_vec_ptr__)) = (typeof(*(__vec_ptr__)))__vector_init_from((__vec_ptr__), sizeof(**(__vec_ptr__)), __capacity__); \
+            __vector_filter_into__((__vec_ptr__), (__filter__), (__new_vec_ptr__));                                                  \
         } while (0)
     #else // COMPILER_SUPPORTS_TYPEOF
         /**
@@ -968,18 +2450,28 @@ void Vector_set_calculate_optimal_capacity_fn(void *vec_ptr, Vector_calculate_op
          * @throw                      [assert]      - If the reference to the new vector is NULL
          * @throw                      [assert]      - If malloc fails
          */
-        #define Vector_filter(__vec_ptr__, __filter__, __new_vec_ptr__, __vec_element_type__) do { \
-            assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                            \
-            (*(__new_vec_ptr__)) = Vector_init(__vec_element_type__);                              \
-            for (size_t __i__ = 0; __i__ < Vector_get_length((__vec_ptr__)); __i__++) {            \
-                if ((__filter__)((*(__vec_ptr__))[__i__])) {                                       \
-                    Vector_push((__new_vec_ptr__), (*(__vec_ptr__))[__i__]);                       \
-                }                                                                                  \
-            }                                                                                      \
+        #define Vector_filter(__vec_ptr__, __filter__, __new_vec_ptr__, __vec_element_type__) do {                                        \
+            assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                                                   \
+            size_t __capacity__;                                                                                                          \
+            __vector_filter_capacity__((__vec_ptr__), (__filter__), __capacity__);                                                        \
+            (*(__new_vec_ptr__)) = (__vec_element_type__ *)__vector_init_from((__vec_ptr__), sizeof(__vec_element_type__), __capacity__); \
+            __vector_filter_into__((__vec_ptr__), (__filter__), (__new_vec_ptr__));                                                       \
         } while (0)
     #endif // COMPILER_SUPPORTS_TYPEOF
 #endif // COMPILER_SUPPORTS_STATEMENT_EXPRESSIONS
 
+/**
+ * Public
+ * 
+ * Filters the vector in place, the elements passing the filter keep their order in the existing buffer
+ * Nothing is allocated: the capacity is left as is (Vector_shrink_to_fit releases it), the dropped elements are released with the element free function
+ * @param __vec_ptr__ [T**]         - A reference to the vector
+ * @param __filter__  [bool (*)(T)] - The filter function to filter the values
+ * @throw             [assert]      - If the reference to the vector is NULL
+ * @throw             [assert]      - If the vector is NULL
+ */
+#define Vector_filter_inplace(__vec_ptr__, __filter__) __vector_compact__((__vec_ptr__), (__filter__), true, false, (size_t *)NULL)
+
 /**
  * Public
  * 
@@ -989,11 +2481,12 @@ void Vector_set_calculate_optimal_capacity_fn(void *vec_ptr, Vector_calculate_op
  * @throw             [assert]       - If the reference to the vector is NULL
  * @throw             [assert]       - If the vector is NULL
  */
-#define Vector_foreach(__vec_ptr__, __func__) do {                              \
-    assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                 \
-    for (size_t __i__ = 0; __i__ < Vector_get_length((__vec_ptr__)); __i__++) { \
-        (__func__)(&((*(__vec_ptr__))[__i__]));                                 \
-    }                                                                           \
+#define Vector_foreach(__vec_ptr__, __func__) do {              \
+    assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n"); \
+    size_t __length__ = Vector_get_length((__vec_ptr__));       \
+    for (size_t __i__ = 0; __i__ < __length__; __i__++) {       \
+        (__func__)(&((*(__vec_ptr__))[__i__]));                 \
+    }                                                           \
 } while (0)
 
 #if COMPILER_SUPPORTS_STATEMENT_EXPRESSIONS
@@ -1009,13 +2502,15 @@ void Vector_set_calculate_optimal_capacity_fn(void *vec_ptr, Vector_calculate_op
      * @throw                          [assert]   - If the vector is NULL
      * @throw                          [assert]   - If malloc fails
      */
-    #define Vector_map(__vec_ptr__, __mapper__, __new_vec_element_type__) ({           \
-        assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                    \
-        __new_vec_element_type__ *__new_vec__ = Vector_init(__new_vec_element_type__); \
-        for (size_t __i__ = 0; __i__ < Vector_get_length((__vec_ptr__)); __i__++) {    \
-            Vector_push(&__new_vec__, (__mapper__)((*(__vec_ptr__))[__i__]));          \
-        }                                                                              \
-        __new_vec__;                                                                   \
+    #define Vector_map(__vec_ptr__, __mapper__, __new_vec_element_type__) ({                                                                                 \
+        assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                                                                          \
+        size_t __length__ = Vector_get_length((__vec_ptr__));                                                                                                \
+        __new_vec_element_type__ *__new_vec__ = (__new_vec_element_type__ *)__vector_init_from((__vec_ptr__), sizeof(__new_vec_element_type__), __length__); \
+        for (size_t __i__ = 0; __i__ < __length__; __i__++) {                                                                                                \
+            __new_vec__[__i__] = (__mapper__)((*(__vec_ptr__))[__i__]);                                                                                      \
+        }                                                                                                                                                    \
+        __vector_get_header(&__new_vec__)->length = __length__;                                                                                              \
+        __new_vec__;                                                                                                                                         \
     })
 #else // COMPILER_SUPPORTS_STATEMENT_EXPRESSIONS
     #if COMPILER_SUPPORTS_TYPEOF
@@ -1031,12 +2526,14 @@ void Vector_set_calculate_optimal_capacity_fn(void *vec_ptr, Vector_calculate_op
          * @throw                 [assert]   - If the reference to the new vector is NULL
          * @throw                 [assert]   - If malloc fails
          */
-        #define Vector_map(__vec_ptr__, __mapper__, __new_vec_ptr__) do {               \
-            assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                 \
-            (*(__new_vec_ptr__)) = Vector_init(typeof(**(__new_vec_ptr__)));            \
-            for (size_t __i__ = 0; __i__ < Vector_get_length((__vec_ptr__)); __i__++) { \
-                Vector_push((__new_vec_ptr__), (__mapper__)((*(__vec_ptr__))[__i__]));  \
-            }                                                                           \
+        #define Vector_map(__vec_ptr__, __mapper__, __new_vec_ptr__) do {                                                                  \
+            assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                                                    \
+            size_t __length__ = Vector_get_length((__vec_ptr__));                                                                          \
+            (*(__new_vec_ptr__)) = (typeof(*(__new_vec_ptr__)))__vector_init_from((__vec_ptr__), sizeof(**(__new_vec_ptr__)), __length__); \
+            for (size_t __i__ = 0; __i__ < __length__; __i__++) {                                                                          \
+                (*(__new_vec_ptr__))[__i__] = (__mapper__)((*(__vec_ptr__))[__i__]);                                                       \
+            }                                                                                                                              \
+            __vector_get_header((__new_vec_ptr__))->length = __length__;                                                                   \
         } while (0)
     #else // COMPILER_SUPPORTS_TYPEOF
         /**
@@ -1052,16 +2549,35 @@ void Vector_set_calculate_optimal_capacity_fn(void *vec_ptr, Vector_calculate_op
          * @throw                          [assert]   - If the reference to the new vector is NULL
          * @throw                          [assert]   - If malloc fails
          */
-        #define Vector_map(__vec_ptr__, __mapper__, __new_vec_ptr__, __new_vec_element_type__) do { \
-            assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                             \
-            (*(__new_vec_ptr__)) = Vector_init(__new_vec_element_type__);                           \
-            for (size_t __i__ = 0; __i__ < Vector_get_length((__vec_ptr__)); __i__++) {             \
-                Vector_push((__new_vec_ptr__), (__mapper__)((*(__vec_ptr__))[__i__]));              \
-            }                                                                                       \
+        #define Vector_map(__vec_ptr__, __mapper__, __new_vec_ptr__, __new_vec_element_type__) do {                                             \
+            assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                                                         \
+            size_t __length__ = Vector_get_length((__vec_ptr__));                                                                               \
+            (*(__new_vec_ptr__)) = (__new_vec_element_type__ *)__vector_init_from((__vec_ptr__), sizeof(__new_vec_element_type__), __length__); \
+            for (size_t __i__ = 0; __i__ < __length__; __i__++) {                                                                               \
+                (*(__new_vec_ptr__))[__i__] = (__mapper__)((*(__vec_ptr__))[__i__]);                                                            \
+            }                                                                                                                                   \
+            __vector_get_header((__new_vec_ptr__))->length = __length__;                                                                        \
         } while (0)
     #endif // COMPILER_SUPPORTS_TYPEOF
 #endif // COMPILER_SUPPORTS_STATEMENT_EXPRESSIONS
 
+/**
+ * Public
+ * 
+ * Maps a function to each value in the vector, overwriting the values in place, nothing is allocated
+ * @param __vec_ptr__ [T**]      - A reference to the vector
+ * @param __mapper__  [T (*)(T)] - The mapper function to map to each value, it returns a value of the type of the vector
+ * @throw             [assert]   - If the reference to the vector is NULL
+ * @throw             [assert]   - If the vector is NULL
+ */
+#define Vector_map_inplace(__vec_ptr__, __mapper__) do {                 \
+    assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");          \
+    size_t __length__ = Vector_get_length((__vec_ptr__));                \
+    for (size_t __i__ = 0; __i__ < __length__; __i__++) {                \
+        (*(__vec_ptr__))[__i__] = (__mapper__)((*(__vec_ptr__))[__i__]); \
+    }                                                                    \
+} while (0)
+
 #if COMPILER_SUPPORTS_STATEMENT_EXPRESSIONS
     #if COMPILER_SUPPORTS_TYPEOF
         /**
@@ -1075,13 +2591,14 @@ void Vector_set_calculate_optimal_capacity_fn(void *vec_ptr, Vector_calculate_op
          * @throw                   [assert]      - If the reference to the vector is NULL
          * @throw                   [assert]      - If the vector is NULL
          */
-        #define Vector_reduce(__vec_ptr__, __reducer__, __initial_value__) ({           \
-            assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                 \
-            typeof((__initial_value__)) accumulator = (__initial_value__);              \
-            for (size_t __i__ = 0; __i__ < Vector_get_length((__vec_ptr__)); __i__++) { \
-                accumulator = (__reducer__)(accumulator, (*(__vec_ptr__))[__i__]);      \
-            }                                                                           \
-            accumulator;                                                                \
+        #define Vector_reduce(__vec_ptr__, __reducer__, __initial_value__) ({      \
+            assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");            \
+            typeof((__initial_value__)) accumulator = (__initial_value__);         \
+            size_t __length__ = Vector_get_length((__vec_ptr__));                  \
+            for (size_t __i__ = 0; __i__ < __length__; __i__++) {                  \
+                accumulator = (__reducer__)(accumulator, (*(__vec_ptr__))[__i__]); \
+            }                                                                      \
+            accumulator;                                                           \
         })
     #else // COMPILER_SUPPORTS_TYPEOF
         /**
@@ -1099,7 +2616,8 @@ void Vector_set_calculate_optimal_capacity_fn(void *vec_ptr, Vector_calculate_op
         #define Vector_reduce(__vec_ptr__, __reducer__, __initial_value__, __accumulator_type__) ({ \
             assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                             \
             __accumulator_type__ accumulator = (__initial_value__);                                 \
-            for (size_t __i__ = 0; __i__ < Vector_get_length((__vec_ptr__)); __i__++) {             \
+            size_t __length__ = Vector_get_length((__vec_ptr__));                                   \
+            for (size_t __i__ = 0; __i__ < __length__; __i__++) {                                   \
                 accumulator = (__reducer__)(accumulator, (*(__vec_ptr__))[__i__]);                  \
             }                                                                                       \
             accumulator;                                                                            \
@@ -1121,7 +2639,8 @@ void Vector_set_calculate_optimal_capacity_fn(void *vec_ptr, Vector_calculate_op
         #define Vector_reduce(__vec_ptr__, __reducer__, __initial_value__, __result_ptr__) do { \
             assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                         \
             typeof((__initial_value__)) __accumulator__ = (__initial_value__);                  \
-            for (size_t __i__ = 0; __i__ < Vector_get_length((__vec_ptr__)); __i__++) {         \
+            size_t __length__ = Vector_get_length((__vec_ptr__));                               \
+            for (size_t __i__ = 0; __i__ < __length__; __i__++) {                               \
                 __accumulator__ = (__reducer__)(__accumulator__, (*(__vec_ptr__))[__i__]);      \
             }                                                                                   \
             if ((__result_ptr__) != NULL) { (*(__result_ptr__)) = __accumulator__; }            \
@@ -1142,7 +2661,8 @@ void Vector_set_calculate_optimal_capacity_fn(void *vec_ptr, Vector_calculate_op
         #define Vector_reduce(__vec_ptr__, __reducer__, __initial_value__, __result_ptr__, __accumulator_type__) do { \
             assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                               \
             __accumulator_type__ __accumulator__ = (__initial_value__);                                               \
-            for (size_t __i__ = 0; __i__ < Vector_get_length((__vec_ptr__)); __i__++) {                               \
+            size_t __length__ = Vector_get_length((__vec_ptr__));                                                     \
+            for (size_t __i__ = 0; __i__ < __length__; __i__++) {                                                     \
                 __accumulator__ = (__reducer__)(__accumulator__, (*(__vec_ptr__))[__i__]);                            \
             }                                                                                                         \
             if ((__result_ptr__) != NULL) { (*(__result_ptr__)) = __accumulator__; }                                  \
@@ -1242,6 +2762,27 @@ void Vector_set_calculate_optimal_capacity_fn(void *vec_ptr, Vector_calculate_op
     } while (0)
 #endif // COMPILER_SUPPORTS_STATEMENT_EXPRESSIONS
 
+/**
+ * Internal
+ * 
+ * Fills a vector presized to the length of the slice, a stepless slice is a single memcpy
+ * @param __vec_ptr__     [T**]    - A reference to the vector
+ * @param __start__       [size_t] - The start index of the slice
+ * @param __step__        [size_t] - The step of the slice
+ * @param __length__      [size_t] - The number of elements of the slice
+ * @param __new_vec_ptr__ [T**]    - A reference to the sliced vector
+ */
+#define __vector_slice_into__(__vec_ptr__, __start__, __step__, __length__, __new_vec_ptr__) do {                                           \
+    if ((__step__) == 1) {                                                                                                                  \
+        if ((__length__) > 0) { memcpy((*(__new_vec_ptr__)), (*(__vec_ptr__)) + (__start__), (__length__) * sizeof(**(__new_vec_ptr__))); } \
+    } else {                                                                                                                                \
+        for (size_t __j__ = 0; __j__ < (__length__); __j__++) {                                                                             \
+            (*(__new_vec_ptr__))[__j__] = (*(__vec_ptr__))[(__start__) + __j__ * (__step__)];                                               \
+        }                                                                                                                                   \
+    }                                                                                                                                       \
+    __vector_get_header((__new_vec_ptr__))->length = (__length__);                                                                          \
+} while (0)
+
 #if COMPILER_SUPPORTS_STATEMENT_EXPRESSIONS
     #if COMPILER_SUPPORTS_TYPEOF
         /**
@@ -1259,17 +2800,16 @@ void Vector_set_calculate_optimal_capacity_fn(void *vec_ptr, Vector_calculate_op
          * @throw             [assert] - If the end index is out of bounds
          * @throw             [assert] - If the step is less than or equal to 0
          */
-        #define Vector_slice(__vec_ptr__, __start__, __end__, __step__) ({                                                                                                 \
-            assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                                                                                    \
-            typeof(*(__vec_ptr__)) __new_vec__ = Vector_init(typeof(**(__vec_ptr__)));                                                                                     \
-            __Vector_Header *__header__ = __vector_get_header((__vec_ptr__));                                                                                              \
-            assertf((__start__) >= 0 && (__start__) <  __header__->length, "ERROR: Start index: %d out of bounds [%d, %zu]\n", (int)__start__, 0, __header__->length - 1); \
-            assertf(( __end__ ) >= 0 && ( __end__ ) <= __header__->length, "ERROR: End index: %d out of bounds [%d, %zu]\n"  , (int)__end__  , 0, __header__->length);     \
-            assertf((__step__) > 0, "ERROR: Step: %d is less than 1\n", __step__);                                                                                         \
-            for (size_t __i__ = (__start__); __i__ < (__end__); __i__ += (__step__)) {                                                                                     \
-                Vector_push(&__new_vec__, (*(__vec_ptr__))[__i__]);                                                                                                        \
-            }                                                                                                                                                              \
-            __new_vec__;                                                                                                                                                   \
+        #define Vector_slice(__vec_ptr__, __start__, __end__, __step__) ({                                                                                                         \
+            assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                                                                                            \
+            __Vector_Header *__header__ = __vector_get_header((__vec_ptr__));                                                                                                      \
+            assertf((__start__) >= 0 && (__start__) <  __header__->length, "ERROR: Start index: %d out of bounds [%d, %zu]\n", (int)__start__, 0, (size_t)__header__->length - 1); \
+            assertf(( __end__ ) >= 0 && ( __end__ ) <= __header__->length, "ERROR: End index: %d out of bounds [%d, %zu]\n"  , (int)__end__  , 0, (size_t)__header__->length);     \
+            assertf((__step__) > 0, "ERROR: Step: %d is less than 1\n", __step__);                                                                                                 \
+            size_t __length__ = (__end__) > (__start__) ? ((__end__) - (__start__) + (__step__) - 1) / (__step__) : 0;                                                             \
+            typeof(*(__vec_ptr__)) __new_vec__ = (typeof(*(__vec_ptr__)))__vector_init_from((__vec_ptr__), sizeof(**(__vec_ptr__)), __length__);                                   \
+            __vector_slice_into__((__vec_ptr__), (__start__), (__step__), __length__, &__new_vec__);                                                                               \
+            __new_vec__;                                                                                                                                                           \
         })
     #else // COMPILER_SUPPORTS_TYPEOF
         /**
@@ -1288,17 +2828,16 @@ void Vector_set_calculate_optimal_capacity_fn(void *vec_ptr, Vector_calculate_op
          * @throw                      [assert]      - If the end index is out of bounds
          * @throw                      [assert]      - If the step is less than or equal to 0
          */
-        #define Vector_slice(__vec_ptr__, __start__, __end__, __step__, __vec_element_type__) ({                                                                           \
-            assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                                                                                    \
-            __vec_element_type__ *__new_vec__ = Vector_init(__vec_element_type__);                                                                                         \
-            __Vector_Header *__header__ = __vector_get_header((__vec_ptr__));                                                                                              \
-            assertf((__start__) >= 0 && (__start__) <  __header__->length, "ERROR: Start index: %d out of bounds [%d, %zu]\n", (int)__start__, 0, __header__->length - 1); \
-            assertf(( __end__ ) >= 0 && ( __end__ ) <= __header__->length, "ERROR: End index: %d out of bounds [%d, %zu]\n"  , (int)__end__  , 0, __header__->length);     \
-            assertf((__step__) > 0, "ERROR: Step: %d is less than 1\n", __step__);                                                                                         \
-            for (size_t __i__ = (__start__); __i__ < (__end__); __i__ += (__step__)) {                                                                                     \
-                Vector_push(&__new_vec__, (*(__vec_ptr__))[__i__]);                                                                                                        \
-            }                                                                                                                                                              \
-            __new_vec__;                                                                                                                                                   \
+        #define Vector_slice(__vec_ptr__, __start__, __end__, __step__, __vec_element_type__) ({                                                                                   \
+            assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                                                                                            \
+            __Vector_Header *__header__ = __vector_get_header((__vec_ptr__));                                                                                                      \
+            assertf((__start__) >= 0 && (__start__) <  __header__->length, "ERROR: Start index: %d out of bounds [%d, %zu]\n", (int)__start__, 0, (size_t)__header__->length - 1); \
+            assertf(( __end__ ) >= 0 && ( __end__ ) <= __header__->length, "ERROR: End index: %d out of bounds [%d, %zu]\n"  , (int)__end__  , 0, (size_t)__header__->length);     \
+            assertf((__step__) > 0, "ERROR: Step: %d is less than 1\n", __step__);                                                                                                 \
+            size_t __length__ = (__end__) > (__start__) ? ((__end__) - (__start__) + (__step__) - 1) / (__step__) : 0;                                                             \
+            __vec_element_type__ *__new_vec__ = (__vec_element_type__ *)__vector_init_from((__vec_ptr__), sizeof(__vec_element_type__), __length__);                               \
+            __vector_slice_into__((__vec_ptr__), (__start__), (__step__), __length__, &__new_vec__);                                                                               \
+            __new_vec__;                                                                                                                                                           \
         })
     #endif // COMPILER_SUPPORTS_TYPEOF
 #else // COMPILER_SUPPORTS_STATEMENT_EXPRESSIONS
@@ -1319,16 +2858,15 @@ void Vector_set_calculate_optimal_capacity_fn(void *vec_ptr, Vector_calculate_op
          * @throw                 [assert]      - If the end index is out of bounds
          * @throw                 [assert]      - If the step is less than or equal to 0
          */
-        #define Vector_slice(__vec_ptr__, __start__, __end__, __step__, __new_vec_ptr__) do {                                                                              \
-            assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                                                                                    \
-            (*(__new_vec_ptr__)) = Vector_init(typeof(**(__vec_ptr__)));                                                                                                   \
-            __Vector_Header *__header__ = __vector_get_header((__vec_ptr__));                                                                                              \
-            assertf((__start__) >= 0 && (__start__) <  __header__->length, "ERROR: Start index: %d out of bounds [%d, %zu]\n", (int)__start__, 0, __header__->length - 1); \
-            assertf(( __end__ ) >= 0 && ( __end__ ) <= __header__->length, "ERROR: End index: %d out of bounds [%d, %zu]\n"  , (int)__end__  , 0, __header__->length);     \
-            assertf((__step__) > 0, "ERROR: Step: %d is less than 1\n", __step__);                                                                                         \
-            for (size_t __i__ = (__start__); __i__ < (__end__); __i__ += (__step__)) {                                                                                     \
-                Vector_push((__new_vec_ptr__), (*(__vec_ptr__))[__i__]);                                                                                                   \
-            }                                                                                                                                                              \
+        #define Vector_slice(__vec_ptr__, __start__, __end__, __step__, __new_vec_ptr__) do {                                                                                      \
+            assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                                                                                            \
+            __Vector_Header *__header__ = __vector_get_header((__vec_ptr__));                                                                                                      \
+            assertf((__start__) >= 0 && (__start__) <  __header__->length, "ERROR: Start index: %d out of bounds [%d, %zu]\n", (int)__start__, 0, (size_t)__header__->length - 1); \
+            assertf(( __end__ ) >= 0 && ( __end__ ) <= __header__->length, "ERROR: End index: %d out of bounds [%d, %zu]\n"  , (int)__end__  , 0, (size_t)__header__->length);     \
+            assertf((__step__) > 0, "ERROR: Step: %d is less than 1\n", __step__);                                                                                                 \
+            size_t __length__ = (__end__) > (__start__) ? ((__end__) - (__start__) + (__step__) - 1) / (__step__) : 0;                                                             \
+            (*(__new_vec_ptr__)) = (typeof(*(__vec_ptr__)))__vector_init_from((__vec_ptr__), sizeof(**(__vec_ptr__)), __length__);                                                 \
+            __vector_slice_into__((__vec_ptr__), (__start__), (__step__), __length__, (__new_vec_ptr__));                                                                          \
         } while (0)
     #else // COMPILER_SUPPORTS_TYPEOF
         /**
@@ -1348,16 +2886,15 @@ void Vector_set_calculate_optimal_capacity_fn(void *vec_ptr, Vector_calculate_op
          * @throw                      [assert]      - If the end index is out of bounds
          * @throw                      [assert]      - If the step is less than or equal to 0
          */
-        #define Vector_slice(__vec_ptr__, __start__, __end__, __step__, __new_vec_ptr__, __vec_element_type__) do {                                                        \
-            assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                                                                                    \
-            (*(__new_vec_ptr__)) = Vector_init(__vec_element_type__);                                                                                                      \
-            __Vector_Header *__header__ = __vector_get_header((__vec_ptr__));                                                                                              \
-            assertf((__start__) >= 0 && (__start__) <  __header__->length, "ERROR: Start index: %d out of bounds [%d, %zu]\n", (int)__start__, 0, __header__->length - 1); \
-            assertf(( __end__ ) >= 0 && ( __end__ ) <= __header__->length, "ERROR: End index: %d out of bounds [%d, %zu]\n"  , (int)__end__  , 0, __header__->length);     \
-            assertf((__step__) > 0, "ERROR: Step: %d is less than 1\n", __step__);                                                                                         \
-            for (size_t __i__ = (__start__); __i__ < (__end__); __i__ += (__step__)) {                                                                                     \
-                Vector_push((__new_vec_ptr__), (*(__vec_ptr__))[__i__]);                                                                                                   \
-            }                                                                                                                                                              \
+        #define Vector_slice(__vec_ptr__, __start__, __end__, __step__, __new_vec_ptr__, __vec_element_type__) do {                                                                \
+            assertf(*(__vec_ptr__) != NULL, "ERROR: Vector is NULL\n");                                                                                                            \
+            __Vector_Header *__header__ = __vector_get_header((__vec_ptr__));                                                                                                      \
+            assertf((__start__) >= 0 && (__start__) <  __header__->length, "ERROR: Start index: %d out of bounds [%d, %zu]\n", (int)__start__, 0, (size_t)__header__->length - 1); \
+            assertf(( __end__ ) >= 0 && ( __end__ ) <= __header__->length, "ERROR: End index: %d out of bounds [%d, %zu]\n"  , (int)__end__  , 0, (size_t)__header__->length);     \
+            assertf((__step__) > 0, "ERROR: Step: %d is less than 1\n", __step__);                                                                                                 \
+            size_t __length__ = (__end__) > (__start__) ? ((__end__) - (__start__) + (__step__) - 1) / (__step__) : 0;                                                             \
+            (*(__new_vec_ptr__)) = (__vec_element_type__ *)__vector_init_from((__vec_ptr__), sizeof(__vec_element_type__), __length__);                                            \
+            __vector_slice_into__((__vec_ptr__), (__start__), (__step__), __length__, (__new_vec_ptr__));                                                                          \
         } while (0)
     #endif // COMPILER_SUPPORTS_TYPEOF
 #endif // COMPILER_SUPPORTS_STATEMENT_EXPRESSIONS